@@ -0,0 +1,160 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <midi/midi1_byte_stream.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+//--------------------------------------------------------------------------
+
+namespace {
+
+using byte_stream_clock = std::chrono::steady_clock;
+
+constexpr size_t byte_stream_size = 1u << 22;
+constexpr int    num_iterations   = 8;
+
+//--------------------------------------------------------------------------
+
+std::vector<uint8_t> make_sysex_stream(size_t sysex_size)
+{
+    std::vector<uint8_t> result;
+    result.reserve(byte_stream_size + sysex_size);
+    while (result.size() < byte_stream_size)
+    {
+        result.push_back(0xF0);
+        result.push_back(0x00);
+        result.push_back(0x21);
+        result.push_back(0x09);
+        for (size_t i = 0; i < sysex_size; ++i)
+            result.push_back(uint8_t(i & 0x7F));
+        result.push_back(0xF7);
+        result.push_back(0xF8);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+std::vector<uint8_t> make_channel_voice_stream()
+{
+    std::vector<uint8_t> result;
+    result.reserve(byte_stream_size + 3);
+    for (uint8_t n = 0; result.size() < byte_stream_size; ++n)
+    {
+        result.push_back(0x90);
+        result.push_back(n & 0x7F);
+        result.push_back(0x40);
+        result.push_back(n & 0x7F); // running status
+        result.push_back(0x00);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+template<typename Parser>
+double measure_bytes_per_second(Parser& parser, const std::vector<uint8_t>& bytes, bool bulk)
+{
+    const auto start = byte_stream_clock::now();
+    for (int i = 0; i < num_iterations; ++i)
+    {
+        if (bulk)
+        {
+            parser.feed(bytes.data(), bytes.size());
+        }
+        else
+        {
+            for (const auto byte : bytes)
+                parser.feed(byte);
+        }
+    }
+    const auto elapsed = std::chrono::duration<double>(byte_stream_clock::now() - start).count();
+
+    return double(bytes.size()) * num_iterations / elapsed;
+}
+
+//--------------------------------------------------------------------------
+
+void run_byte_stream_benchmark(const char* name, const std::vector<uint8_t>& bytes, bool with_sysex_callback)
+{
+    size_t num_packets = 0;
+    size_t num_sysex   = 0;
+
+    auto on_packet = [&num_packets](midi::universal_packet) { ++num_packets; };
+    auto on_sysex  = [&num_sysex](const midi::sysex7&) { ++num_sysex; };
+
+    midi::midi1_byte_stream_parser::sysex_callback sysex_cb;
+    if (with_sysex_callback)
+        sysex_cb = on_sysex;
+
+    midi::midi1_byte_stream_parser parser{ on_packet, sysex_cb };
+
+    const auto single = measure_bytes_per_second(parser, bytes, false);
+    const auto bulk   = measure_bytes_per_second(parser, bytes, true);
+
+    double inlined = 0.;
+    if (with_sysex_callback)
+    {
+        midi::basic_midi1_byte_stream_parser<decltype(on_packet), decltype(on_sysex)> p{ on_packet, on_sysex };
+        inlined = measure_bytes_per_second(p, bytes, true);
+    }
+    else
+    {
+        midi::basic_midi1_byte_stream_parser<decltype(on_packet)> p{ on_packet };
+        inlined = measure_bytes_per_second(p, bytes, true);
+    }
+
+    std::printf("%-20s %-14s single byte: %8.2f MB/s  bulk: %8.2f MB/s  bulk, template sinks: %8.2f MB/s\n",
+                name,
+                with_sysex_callback ? "sysex callback" : "packets",
+                single / 1e6,
+                bulk / 1e6,
+                inlined / 1e6);
+
+    if ((num_packets == 0) && (num_sysex == 0))
+        std::printf("no output\n");
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------
+
+void run_midi1_byte_stream_benchmarks()
+{
+    std::printf("midi1_byte_stream_parser, %u bytes x %d\n", unsigned(byte_stream_size), num_iterations);
+
+    const auto small_sysex   = make_sysex_stream(16);
+    const auto large_sysex   = make_sysex_stream(4096);
+    const auto channel_voice = make_channel_voice_stream();
+
+    for (const bool with_sysex_callback : { false, true })
+    {
+        run_byte_stream_benchmark("SysEx (16 bytes)", small_sysex, with_sysex_callback);
+        run_byte_stream_benchmark("SysEx (4096 bytes)", large_sysex, with_sysex_callback);
+        run_byte_stream_benchmark("channel voice", channel_voice, with_sysex_callback);
+    }
+}
+
+//--------------------------------------------------------------------------
@@ -0,0 +1,171 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <midi/ump_mpsc_queue.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+//--------------------------------------------------------------------------
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr size_t   queue_capacity = 1024;
+constexpr uint32_t total_packets  = 1u << 18;
+
+//--------------------------------------------------------------------------
+//! reference: bounded queue protected by a mutex
+class mutex_queue
+{
+  public:
+    using entry = midi::ump_mpsc_queue::entry;
+
+    bool try_push(const entry& e)
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        if (m_entries.size() >= queue_capacity)
+            return false;
+        m_entries.push_back(e);
+        return true;
+    }
+
+    std::optional<entry> try_pop()
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        if (m_entries.empty())
+            return std::nullopt;
+        auto result = m_entries.front();
+        m_entries.pop_front();
+        return result;
+    }
+
+  private:
+    std::mutex        m_mutex;
+    std::deque<entry> m_entries;
+};
+
+//--------------------------------------------------------------------------
+
+midi::universal_packet make_timestamped_packet(uint32_t index)
+{
+    const auto now = uint64_t(clock_type::now().time_since_epoch().count());
+    return midi::universal_packet{ 0x40903C00u, index, uint32_t(now >> 32), uint32_t(now) };
+}
+
+//--------------------------------------------------------------------------
+
+template<typename Queue>
+void run_merge_benchmark(const char* name, uint16_t num_producers)
+{
+    Queue      queue{};
+    const auto packets_per_producer = total_packets / num_producers;
+    const auto num_packets          = packets_per_producer * num_producers;
+
+    std::vector<clock_type::rep> latencies;
+    latencies.reserve(num_packets);
+
+    const auto start = clock_type::now();
+
+    std::vector<std::thread> producers;
+    for (uint16_t s = 0; s < num_producers; ++s)
+    {
+        producers.emplace_back([&queue, s, packets_per_producer]() {
+            for (uint32_t i = 0; i < packets_per_producer;)
+            {
+                if (queue.try_push({ make_timestamped_packet(i), s, i }))
+                    ++i;
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    for (uint32_t received = 0; received < num_packets;)
+    {
+        if (auto e = queue.try_pop())
+        {
+            const auto sent = (uint64_t(e->packet.data[2]) << 32) | e->packet.data[3];
+            latencies.push_back(clock_type::now().time_since_epoch().count() - clock_type::rep(sent));
+            ++received;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    const auto elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+
+    for (auto& t : producers)
+        t.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto to_us = [](clock_type::rep ticks) {
+        return std::chrono::duration<double, std::micro>(clock_type::duration{ ticks }).count();
+    };
+
+    std::printf("%-12s producers: %2u  throughput: %8.2f Mpackets/s  latency median: %9.2f us  p99: %9.2f us\n",
+                name,
+                unsigned(num_producers),
+                num_packets / elapsed / 1e6,
+                to_us(latencies[latencies.size() / 2]),
+                to_us(latencies[latencies.size() * 99 / 100]));
+}
+
+//--------------------------------------------------------------------------
+
+struct lock_free_queue : midi::ump_mpsc_queue
+{
+    lock_free_queue()
+      : midi::ump_mpsc_queue(queue_capacity)
+    {
+    }
+};
+
+} // namespace
+
+//--------------------------------------------------------------------------
+
+void run_ump_mpsc_queue_benchmarks()
+{
+    std::printf("ump_mpsc_queue vs. mutex protected queue, %u packets, capacity %u\n",
+                unsigned(total_packets),
+                unsigned(queue_capacity));
+
+    constexpr uint16_t producer_counts[] = { 1, 2, 4, 8, 16, 32 };
+
+    for (const uint16_t num_producers : producer_counts)
+    {
+        run_merge_benchmark<lock_free_queue>("lock-free", num_producers);
+        run_merge_benchmark<mutex_queue>("mutex", num_producers);
+    }
+}
+
+//--------------------------------------------------------------------------
@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/types.h>
+#include <midi/universal_packet.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! Coalesces dense controller streams
+/*! Controller messages are held back and replaced by later messages of the same group,
+    channel and controller (and note for per note controllers), so that only the latest value
+    is passed on. Pending messages are flushed in order of their first arrival, either all at
+    once at the end of a processing block with `flush(sink)`, or after they were pending for
+    `window_us()` with `flush(now_us, sink)`.
+
+    Coalesced are poly pressure, control change (except bank select, data entry, high
+    resolution velocity prefix, RPN / NRPN selection and channel mode messages), channel
+    pressure and pitch bend of both protocols, and the MIDI 2 registered / assignable
+    controllers, per note controllers and per note pitch bend. Any other channel voice
+    message, e.g. a note on / off or a reset all controllers, first flushes the pending
+    messages of its group and channel, so their order relative to it is preserved. All
+    other packets are passed on immediately. */
+class controller_coalescer
+{
+  public:
+    explicit controller_coalescer(size_t max_pending_packets = 256, uint64_t window_us = 1000);
+
+    uint64_t window_us() const { return m_window; }
+    void     set_window_us(uint64_t window_us) { m_window = window_us; }
+
+    //! push a packet, packets that are not held back are passed to `sink`
+    template<typename Sink>
+    void push(const universal_packet&, uint64_t timestamp_us, Sink&&);
+    template<typename Sink>
+    void push(const universal_packet& p, Sink&& sink)
+    {
+        push(p, 0, sink);
+    }
+
+    //! flush all pending packets
+    template<typename Sink>
+    size_t flush(Sink&&);
+
+    //! flush packets pending since at least `window_us()`
+    template<typename Sink>
+    size_t flush(uint64_t now_us, Sink&&);
+
+    size_t size() const { return m_pending.size(); }
+    bool   empty() const { return m_pending.empty(); }
+    size_t capacity() const { return m_capacity; }
+
+    void clear() { m_pending.clear(); }
+
+    //! key identifying the coalesced controller, 0 if the packet is not coalesced
+    static uint32_t coalescing_key(const universal_packet&);
+
+  private:
+    struct entry
+    {
+        uint32_t         key;
+        uint64_t         timestamp;
+        universal_packet packet;
+    };
+
+    //! replace the pending packet with the same key or add the packet, false if full
+    bool hold(uint32_t key, const universal_packet&, uint64_t timestamp_us);
+
+    //! flush pending packets matching `pred` in order, keeping the order of all other packets
+    template<typename Predicate, typename Sink>
+    size_t flush_if(Predicate&&, Sink&&);
+
+    std::vector<entry> m_pending;
+    size_t             m_capacity;
+    uint64_t           m_window;
+};
+
+//--------------------------------------------------------------------------
+// implementation
+//--------------------------------------------------------------------------
+
+template<typename Sink>
+void controller_coalescer::push(const universal_packet& p, uint64_t timestamp_us, Sink&& sink)
+{
+    if (const auto key = coalescing_key(p))
+    {
+        if (!hold(key, p, timestamp_us))
+            sink(p);
+        return;
+    }
+
+    if (p.is_channel_voice_message())
+    {
+        const auto group_and_channel = p.data[0] & 0x0F0F0000u;
+        flush_if([group_and_channel](const entry& e) { return (e.key & 0x0F0F0000u) == group_and_channel; }, sink);
+    }
+
+    sink(p);
+}
+
+//--------------------------------------------------------------------------
+
+template<typename Sink>
+size_t controller_coalescer::flush(Sink&& sink)
+{
+    for (const auto& e : m_pending)
+        sink(e.packet);
+
+    const auto result = m_pending.size();
+    m_pending.clear();
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+template<typename Sink>
+size_t controller_coalescer::flush(uint64_t now_us, Sink&& sink)
+{
+    return flush_if([this, now_us](const entry& e) { return e.timestamp + m_window <= now_us; }, sink);
+}
+
+//--------------------------------------------------------------------------
+
+template<typename Predicate, typename Sink>
+size_t controller_coalescer::flush_if(Predicate&& pred, Sink&& sink)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < m_pending.size(); ++i)
+    {
+        if (pred(m_pending[i]))
+            sink(m_pending[i].packet);
+        else
+            m_pending[kept++] = m_pending[i];
+    }
+
+    const auto result = m_pending.size() - kept;
+    m_pending.resize(kept);
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/protocol_translator.h>
+#include <midi/types.h>
+#include <midi/universal_packet.h>
+
+#include <cstddef>
+#include <cstdint>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! Adapts outgoing traffic to the protocol negotiated with a UMP endpoint
+/*! Packets received from the endpoint are passed to `process_endpoint_packet()`, which tracks
+    the protocol and JR extensions of stream configuration notifications and the groups of
+    active MIDI 1 function blocks. `adapt()` converts outgoing channel voice messages to the
+    protocol of their group using `midi2_to_midi1_translator` / `midi1_to_midi2_translator`:
+    - with MIDI 1 protocol, all groups are MIDI 1
+    - with MIDI 2 protocol, groups of active function blocks with `function_block_options::midi1`
+      set are MIDI 1, all other groups are MIDI 2
+
+    JR clock and JR timestamp messages are dropped unless the endpoint receives JR timestamps
+    (`extensions::jitter_reduction_receive`), all other packets pass unchanged. A single packet
+    results in at most `max_packets_per_packet` packets. */
+class endpoint_protocol_adapter
+{
+  public:
+    static constexpr size_t max_packets_per_packet = midi2_to_midi1_translator::max_packets_per_packet;
+
+    //! protocol and extensions in use until the endpoint notifies its stream configuration
+    explicit endpoint_protocol_adapter(protocol_t = protocol::midi1, extensions_t = 0);
+
+    //! process a packet received from the endpoint, returns true if the configuration changed
+    bool process_endpoint_packet(const universal_packet&);
+
+    protocol_t   protocol() const { return m_protocol; }
+    extensions_t extensions() const { return m_extensions; }
+    protocol_t   group_protocol(group_t) const;
+
+    //! adapt an outgoing packet, passing resulting packets to `sink`
+    template<typename Sink>
+    void adapt(const universal_packet&, Sink&&);
+
+    //! adapt an outgoing packet, returns the number of packets written to `out`
+    size_t adapt(const universal_packet&, universal_packet out[max_packets_per_packet]);
+
+    //! adapt outgoing packets into `out`, which needs room for `num_packets * max_packets_per_packet` packets
+    /*! Returns the number of packets written. */
+    size_t adapt(const universal_packet* packets, size_t num_packets, universal_packet* out);
+
+    //! reset the translator state, e.g. after the endpoint was reconnected
+    void reset();
+
+  private:
+    static constexpr size_t max_function_blocks = 32;
+
+    protocol_t   m_protocol;
+    extensions_t m_extensions;
+    uint16_t     m_midi1_groups;                               //!< groups of active MIDI 1 function blocks
+    uint16_t     m_function_block_groups[max_function_blocks]; //!< MIDI 1 groups per function block
+
+    midi2_to_midi1_translator m_to_midi1;
+    midi1_to_midi2_translator m_to_midi2;
+};
+
+//--------------------------------------------------------------------------
+// implementation
+//--------------------------------------------------------------------------
+
+template<typename Sink>
+void endpoint_protocol_adapter::adapt(const universal_packet& p, Sink&& sink)
+{
+    universal_packet packets[max_packets_per_packet];
+
+    const auto num_packets = adapt(p, packets);
+    for (size_t i = 0; i < num_packets; ++i)
+        sink(packets[i]);
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
@@ -70,6 +70,13 @@ struct jr_timestamp_t
     }
 };
 
+//--------------------------------------------------------------------------
+//! wrap-around aware comparison, timestamps must be less than half the timestamp range apart
+inline bool is_earlier(jr_timestamp_t a, jr_timestamp_t b)
+{
+    return static_cast<int16_t>(static_cast<uint16_t>(a.value - b.value)) < 0;
+}
+
 //--------------------------------------------------------------------------
 
 class jr_clock
@@ -24,12 +24,20 @@
 
 //--------------------------------------------------------------------------
 
+#include <midi/data_message.h>
+#include <midi/midi1_channel_voice_message.h>
 #include <midi/sysex.h>
+#include <midi/system_message.h>
 #include <midi/types.h>
 #include <midi/universal_packet.h>
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
+#include <type_traits>
 #include <utility>
 
 //--------------------------------------------------------------------------
@@ -38,14 +46,75 @@ namespace midi {
 
 //--------------------------------------------------------------------------
 
-class midi1_byte_stream_parser
+namespace impl {
+
+    //! find the first byte with the high bit set, testing eight bytes at once
+    inline const uint8_t* find_status_byte(const uint8_t* begin, const uint8_t* end)
+    {
+        constexpr uint64_t high_bits = 0x8080808080808080ull;
+
+        while (end - begin >= 8)
+        {
+            uint64_t chunk;
+            std::memcpy(&chunk, begin, sizeof(chunk));
+            if (chunk & high_bits)
+                break;
+            begin += 8;
+        }
+
+        while ((begin != end) && (*begin < 0x80))
+            ++begin;
+
+        return begin;
+    }
+
+} // namespace impl
+
+//--------------------------------------------------------------------------
+//! slice of a SysEx message delivered to a chunked SysEx sink
+/*! `data` points to the payload bytes following the manufacturer ID and is only valid
+    during the invocation of the sink. */
+struct sysex7_chunk
+{
+    packet_format  format{ packet_format::complete }; //!< position of the chunk within the message
+    manufacturer_t manufacturerID{ 0 };               //!< manufacturer ID, \see midi::manufacturer
+    const uint8_t* data{ nullptr };
+    size_t         size{ 0 };
+};
+
+//--------------------------------------------------------------------------
+
+namespace impl {
+
+    template<typename SysexSink>
+    constexpr bool is_sysex7_chunk_sink = std::is_invocable_v<SysexSink&, const sysex7_chunk&>;
+
+} // namespace impl
+
+//--------------------------------------------------------------------------
+
+//! MIDI 1 byte stream parser
+/*! `PacketSink` is invoked with each parsed `universal_packet`, `SysexSink` with each
+    complete `sysex7` message. Sinks can be any callables, passing lambdas or function
+    objects allows the compiler to inline them into the parser loop. If `SysexSink` is
+    `std::nullptr_t` or an empty `std::function`, SysEx messages are delivered as
+    `sysex7` packets via `PacketSink`.
+
+    If `SysexSink` is invocable with a `sysex7_chunk`, SysEx payload is delivered in slices
+    of at most `sysex_chunk_size()` bytes as it arrives instead of being collected, which
+    keeps memory bounded for large messages. The first slice is a `start` chunk, followed by
+    `cont` chunks and an `end` chunk, a message fitting into a single slice is delivered as
+    a `complete` chunk. A message cancelled by an unexpected status byte does not get an
+    `end` chunk. */
+template<typename PacketSink, typename SysexSink = std::nullptr_t>
+class basic_midi1_byte_stream_parser
 {
   public:
-    using packet_callback = std::function<void(universal_packet)>;
-    using sysex_callback  = std::function<void(const midi::sysex7&)>;
+    using packet_callback = PacketSink;
+    using sysex_callback  = SysexSink;
 
-    explicit midi1_byte_stream_parser(packet_callback, sysex_callback = {}, bool enable_callbacks = true);
-    midi1_byte_stream_parser(group_t, packet_callback, sysex_callback = {}, bool enable_callbacks = true);
+    explicit basic_midi1_byte_stream_parser(packet_callback, sysex_callback = {}, bool enable_callbacks = true);
+    basic_midi1_byte_stream_parser(group_t, packet_callback, sysex_callback = {}, bool enable_callbacks = true);
 
     bool callbacks_enabled() const { return m_invoke_callbacks; }
     void enable_callbacks(bool enable) { m_invoke_callbacks = enable; }
@@ -53,23 +122,33 @@ class midi1_byte_stream_parser
     group_t group() const;
     void    set_group(group_t);
 
+    size_t sysex_chunk_size() const { return m_sysex_chunk_size; }
+    void   set_sysex_chunk_size(size_t);
+
     void feed(uint8_t);
     void feed(const uint8_t* data, size_t num_bytes);
     void feed(const uint8_t* begin, const uint8_t* end);
 
+    size_t parse(const uint8_t* in, size_t num_bytes, universal_packet* out, size_t out_capacity, size_t& consumed);
+
     void reset();
 
   protected:
+    void post_packet(const universal_packet&);
+
     void system_realtime(uint8_t);
     void system_common(uint8_t);
     void channel_voice(uint8_t);
 
-    bool has_sysex_callback() const { return static_cast<bool>(m_sysex_callback); }
+    bool has_sysex_callback() const;
 
     void sysex_start();
     void sysex_continue_callback(uint8_t);
+    void sysex_continue_callback(const uint8_t* begin, const uint8_t* end);
     void sysex_end_callback();
+    void sysex_chunk_callback(packet_format);
     void sysex_continue_packet(uint8_t);
+    void sysex_continue_packet(const uint8_t* begin, const uint8_t* end);
     void sysex_end_packet();
 
   private:
@@ -83,10 +162,24 @@ class midi1_byte_stream_parser
 
     uint8_t m_packet_byte{ 0 };
     uint8_t m_num_missing_bytes{ 0 };
+
+    size_t m_sysex_chunk_size{ 256 };   //!< maximum payload size of a `sysex7_chunk`
+    bool   m_sysex_chunk_sent{ false }; //!< a chunk of the current SysEx message has been delivered
+
+    universal_packet* m_output{ nullptr }; //!< output buffer while parsing via parse()
+    size_t            m_num_output{ 0 };
 };
 
 //--------------------------------------------------------------------------
 
+using midi1_byte_stream_parser =
+  basic_midi1_byte_stream_parser<std::function<void(universal_packet)>, std::function<void(const midi::sysex7&)>>;
+
+extern template class basic_midi1_byte_stream_parser<std::function<void(universal_packet)>,
+                                                     std::function<void(const midi::sysex7&)>>;
+
+//--------------------------------------------------------------------------
+
 constexpr universal_packet from_midi1_byte_stream(uint8_t status, uint7_t d1, uint7_t d2);
 
 //--------------------------------------------------------------------------
@@ -97,21 +190,66 @@ constexpr size_t midi1_byte_stream_size(const universal_packet&);
 
 size_t to_midi1_byte_stream(const universal_packet&, uint8_t bytes[8]);
 
+//--------------------------------------------------------------------------
+//! Stateful UMP to MIDI 1 byte stream serializer
+/*! Reduces the number of bytes on bandwidth limited MIDI 1 links:
+    - running status omits repeated channel voice status bytes, it is cancelled by
+      system common and SysEx messages, but not by realtime messages
+    - note off messages can be sent as note on messages with velocity zero, so that
+      running status also applies to mixed note on / off sequences
+    - realtime messages can be serialized ahead of all other messages of a block
+
+    Packets without MIDI 1 byte stream representation are ignored. */
+class midi1_byte_stream_serializer
+{
+  public:
+    static constexpr size_t max_bytes_per_packet = 8;
+
+    explicit midi1_byte_stream_serializer(bool running_status = true);
+
+    bool running_status_enabled() const { return m_use_running_status; }
+    void enable_running_status(bool);
+
+    bool note_off_as_note_on_enabled() const { return m_note_off_as_note_on; }
+    void enable_note_off_as_note_on(bool enable) { m_note_off_as_note_on = enable; }
+
+    bool realtime_first_enabled() const { return m_realtime_first; }
+    void enable_realtime_first(bool enable) { m_realtime_first = enable; }
+
+    //! serialize a single packet, returns the number of bytes written
+    size_t serialize(const universal_packet&, uint8_t bytes[max_bytes_per_packet]);
+
+    //! serialize a block of packets into `out`, which needs room for `num_packets * max_bytes_per_packet` bytes
+    /*! Returns the number of bytes written. */
+    size_t serialize(const universal_packet* packets, size_t num_packets, uint8_t* out);
+
+    //! forget the running status, the next channel voice message is sent with status byte
+    void reset() { m_running_status = 0; }
+
+  private:
+    uint8_t m_running_status{ 0 };
+    bool    m_use_running_status{ true };
+    bool    m_note_off_as_note_on{ false };
+    bool    m_realtime_first{ false };
+};
+
 //--------------------------------------------------------------------------
 
-inline midi1_byte_stream_parser::midi1_byte_stream_parser(packet_callback pcb,
-                                                          sysex_callback  sxcb,
-                                                          bool            enable_callbacks)
+template<typename PacketSink, typename SysexSink>
+basic_midi1_byte_stream_parser<PacketSink, SysexSink>::basic_midi1_byte_stream_parser(packet_callback pcb,
+                                                                                      sysex_callback  sxcb,
+                                                                                      bool            enable_callbacks)
   : m_packet_callback(std::move(pcb))
   , m_sysex_callback(std::move(sxcb))
   , m_invoke_callbacks(enable_callbacks)
 {
 }
 
-inline midi1_byte_stream_parser::midi1_byte_stream_parser(group_t         group,
-                                                          packet_callback pcb,
-                                                          sysex_callback  sxcb,
-                                                          bool            enable_callbacks)
+template<typename PacketSink, typename SysexSink>
+basic_midi1_byte_stream_parser<PacketSink, SysexSink>::basic_midi1_byte_stream_parser(group_t         group,
+                                                                                      packet_callback pcb,
+                                                                                      sysex_callback  sxcb,
+                                                                                      bool            enable_callbacks)
   : m_group(group)
   , m_packet_callback(std::move(pcb))
   , m_sysex_callback(std::move(sxcb))
@@ -121,27 +259,540 @@ inline midi1_byte_stream_parser::midi1_byte_stream_parser(group_t         group,
 
 //--------------------------------------------------------------------------
 
-inline group_t midi1_byte_stream_parser::group() const
+template<typename PacketSink, typename SysexSink>
+group_t basic_midi1_byte_stream_parser<PacketSink, SysexSink>::group() const
 {
     return m_group;
 }
 
 //--------------------------------------------------------------------------
 
-inline void midi1_byte_stream_parser::set_group(group_t group)
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::set_group(group_t group)
 {
     m_group = group;
 }
 
 //--------------------------------------------------------------------------
 
-inline void midi1_byte_stream_parser::feed(const uint8_t* data, size_t num_bytes)
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::set_sysex_chunk_size(size_t size)
+{
+    assert(size > 0);
+    m_sysex_chunk_size = std::max(size, size_t{ 1 });
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::feed(const uint8_t* data, size_t num_bytes)
 {
     feed(data, data + num_bytes);
 }
 
 //--------------------------------------------------------------------------
 
+template<typename PacketSink, typename SysexSink>
+bool basic_midi1_byte_stream_parser<PacketSink, SysexSink>::has_sysex_callback() const
+{
+    if constexpr (std::is_same_v<SysexSink, std::nullptr_t>)
+        return false;
+    else if constexpr (std::is_constructible_v<bool, const SysexSink&>)
+        return static_cast<bool>(m_sysex_callback); // std::function, function pointer
+    else
+        return true;
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::feed(uint8_t byte)
+{
+    if (byte >= system_status::clock) // realtime messages
+    {
+        system_realtime(byte);
+        return;
+    }
+
+    if (m_packet.type() == packet_type::data) // SysEx in progress?
+    {
+        if (byte < 0x80) // SysEx data
+        {
+            if (has_sysex_callback()) // SysEx callbacks enabled?
+            {
+                sysex_continue_callback(byte);
+            }
+            else
+            {
+                sysex_continue_packet(byte);
+            }
+
+            return;
+        }
+        else // end of SysEx
+        {
+            if (byte != 0xF7) // cancel invalid SysEx message
+            {
+                m_packet = universal_packet{};
+            }
+            else // end of SysEx
+            {
+                if (has_sysex_callback()) // SysEx callbacks enabled?
+                {
+                    sysex_end_callback();
+                }
+                else
+                {
+                    sysex_end_packet();
+                }
+
+                return;
+            }
+        }
+    }
+
+    if (byte == 0xF0) // SysEx start
+    {
+        sysex_start();
+    }
+    else if (byte > 0xF0) // System Common
+    {
+        system_common(byte);
+    }
+    else if (byte >= 0x80) // channel voice message
+    {
+        channel_voice(byte);
+    }
+    else if (m_packet.status() && m_num_missing_bytes && (m_packet_byte < 4))
+    {
+        m_packet.set_byte(m_packet_byte, byte);
+        --m_num_missing_bytes;
+        if (m_num_missing_bytes == 0)
+        {
+            // handle running status
+            if (m_packet.status() < 0xF0)
+            {
+                m_num_missing_bytes = m_packet_byte - 1;
+                m_packet_byte       = 2;
+            }
+
+            // post packet
+            post_packet(m_packet);
+
+            if (m_packet.status() >= 0xF0)
+            {
+                // cancel running status on SystemCommon messages
+                m_packet = universal_packet{};
+            }
+        }
+        else
+        {
+            ++m_packet_byte;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::feed(const uint8_t* begin, const uint8_t* end)
+{
+    while (begin < end)
+    {
+        if (m_packet.type() == packet_type::data) // SysEx in progress?
+        {
+            // process runs of SysEx data bytes in bulk
+            const auto* run_end = impl::find_status_byte(begin, end);
+            if (run_end != begin)
+            {
+                if (has_sysex_callback())
+                {
+                    sysex_continue_callback(begin, run_end);
+                }
+                else
+                {
+                    sysex_continue_packet(begin, run_end);
+                }
+
+                begin = run_end;
+                continue;
+            }
+        }
+
+        feed(*begin++);
+    }
+}
+
+//--------------------------------------------------------------------------
+//! parse bytes into a packet buffer instead of passing packets to the packet callback
+/*! Stops when either all bytes are consumed or the packet buffer is full, the number of
+    consumed bytes is returned in `consumed`. Parsing can be resumed with the remaining
+    bytes. SysEx messages are still passed to the SysEx callback if enabled.
+    Returns the number of packets written to `out`. */
+template<typename PacketSink, typename SysexSink>
+size_t basic_midi1_byte_stream_parser<PacketSink, SysexSink>::parse(
+  const uint8_t* in, size_t num_bytes, universal_packet* out, size_t out_capacity, size_t& consumed)
+{
+    assert(in || !num_bytes);
+    assert(out || !out_capacity);
+
+    m_output     = out;
+    m_num_output = 0;
+    consumed     = 0;
+
+    // a single byte completes at most one packet
+    while ((consumed < num_bytes) && (m_num_output < out_capacity))
+    {
+        const auto n = std::min(num_bytes - consumed, out_capacity - m_num_output);
+        feed(in + consumed, n);
+        consumed += n;
+    }
+
+    m_output = nullptr;
+    return m_num_output;
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::post_packet(const universal_packet& p)
+{
+    if (m_output)
+    {
+        m_output[m_num_output++] = p;
+    }
+    else if constexpr (!std::is_same_v<PacketSink, std::nullptr_t>)
+    {
+        if (m_invoke_callbacks)
+        {
+            m_packet_callback(p);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------
+//! reset the parser state
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::reset()
+{
+    m_packet = universal_packet{};
+    m_sysex.clear();
+
+    m_packet_byte       = 1;
+    m_num_missing_bytes = 0;
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::system_realtime(uint8_t byte)
+{
+    if ((byte == 0xF9) || (byte == 0xFD))
+        // undefined
+        return;
+
+    // post packet
+    post_packet(make_system_message(m_group, byte));
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::system_common(uint8_t byte)
+{
+    m_packet            = make_system_message(m_group, byte);
+    m_packet_byte       = 2;
+    m_num_missing_bytes = 0;
+
+    switch (m_packet.status())
+    {
+    case system_status::mtc_quarter_frame:
+    case system_status::song_select:
+        m_num_missing_bytes = 1;
+        break;
+    case system_status::song_position:
+        m_num_missing_bytes = 2;
+        break;
+    case system_status::tune_request:
+        break;
+    default:
+        // undefined, skip, cancel running status
+        m_packet = universal_packet{};
+        return;
+    }
+
+    if (m_num_missing_bytes == 0)
+    {
+        // post packet
+        post_packet(m_packet);
+
+        // reset
+        m_packet = universal_packet{};
+    }
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::channel_voice(uint8_t byte)
+{
+    m_packet            = midi1_channel_voice_message{ m_group, byte };
+    m_packet_byte       = 2;
+    m_num_missing_bytes = 0;
+
+    switch (m_packet.status() & 0xF0)
+    {
+    case midi1_channel_voice_status::note_off:
+    case midi1_channel_voice_status::note_on:
+    case midi1_channel_voice_status::poly_pressure:
+    case midi1_channel_voice_status::control_change:
+    case midi1_channel_voice_status::pitch_bend:
+        m_num_missing_bytes = 2;
+        break;
+    case midi1_channel_voice_status::program_change:
+    case midi1_channel_voice_status::channel_pressure:
+        m_num_missing_bytes = 1;
+        break;
+    default:
+        break;
+    }
+
+    if (m_num_missing_bytes == 0)
+    {
+        // post packet
+        post_packet(m_packet);
+    }
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::sysex_start()
+{
+    m_packet            = make_sysex7_start_packet(m_group);
+    m_packet_byte       = 2;
+    m_num_missing_bytes = 0;
+
+    if (has_sysex_callback())
+    {
+        m_sysex.clear();
+        m_sysex_chunk_sent = false;
+
+        if constexpr (impl::is_sysex7_chunk_sink<SysexSink>)
+        {
+            if (m_sysex.data.capacity() < m_sysex_chunk_size)
+                m_sysex.data.reserve(m_sysex_chunk_size);
+        }
+        else if (m_sysex.data.capacity() < 1024)
+        {
+            m_sysex.data.reserve(1024);
+        }
+
+        if (!m_invoke_callbacks)
+            m_packet_byte = 0; // do not collect any data
+    }
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::sysex_continue_callback(uint8_t byte)
+{
+    switch (m_packet_byte)
+    {
+    case 0:
+    case 1:
+        // skip SysEx data
+        return;
+    case 2: // Manufacturer
+        m_sysex.manufacturerID = (byte << 16);
+        ++m_packet_byte;
+        return;
+    case 3:
+    case 4:
+        if ((m_sysex.manufacturerID & 0xFF0000) == 0) // three byte manufacturer ?
+        {
+            m_sysex.manufacturerID += (byte << ((4 - m_packet_byte) * 8));
+            ++m_packet_byte;
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+
+    if constexpr (impl::is_sysex7_chunk_sink<SysexSink>)
+    {
+        // deliver the collected slice
+        if (m_sysex.data.size() >= m_sysex_chunk_size)
+        {
+            sysex_chunk_callback(m_sysex_chunk_sent ? packet_format::cont : packet_format::start);
+        }
+    }
+    else if (m_sysex.data.size() == m_sysex.data.capacity()) // resize necessary?
+    {
+        m_sysex.data.reserve(m_sysex.data.capacity() * 2);
+    }
+
+    // collect the data
+    m_sysex.data.push_back(byte);
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::sysex_continue_callback(const uint8_t* begin,
+                                                                                    const uint8_t* end)
+{
+    if (m_packet_byte < 2)
+        // skip SysEx data
+        return;
+
+    // manufacturer
+    while ((begin != end) &&
+           ((m_packet_byte == 2) || ((m_packet_byte < 5) && ((m_sysex.manufacturerID & 0xFF0000) == 0))))
+    {
+        sysex_continue_callback(*begin++);
+    }
+
+    // collect the data
+    if constexpr (impl::is_sysex7_chunk_sink<SysexSink>)
+    {
+        while (begin != end)
+        {
+            if (m_sysex.data.size() >= m_sysex_chunk_size)
+            {
+                sysex_chunk_callback(m_sysex_chunk_sent ? packet_format::cont : packet_format::start);
+            }
+
+            const auto n = std::min(m_sysex_chunk_size - m_sysex.data.size(), size_t(end - begin));
+            m_sysex.data.insert(m_sysex.data.end(), begin, begin + n);
+            begin += n;
+        }
+    }
+    else
+    {
+        m_sysex.data.insert(m_sysex.data.end(), begin, end);
+    }
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::sysex_end_callback()
+{
+    m_packet = universal_packet{};
+
+    if (((m_sysex.manufacturerID & 0xFF0000) == 0) && (m_packet_byte < 5))
+    {
+        // incomplete three byte manufacturer, invalid
+        return;
+    }
+
+    // notify SysEx
+    if constexpr (impl::is_sysex7_chunk_sink<SysexSink>)
+    {
+        sysex_chunk_callback(m_sysex_chunk_sent ? packet_format::end : packet_format::complete);
+    }
+    else if constexpr (!std::is_same_v<SysexSink, std::nullptr_t>)
+    {
+        if (m_invoke_callbacks)
+        {
+            m_sysex_callback(m_sysex);
+        }
+    }
+    m_sysex.clear();
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::sysex_chunk_callback(packet_format format)
+{
+    if constexpr (impl::is_sysex7_chunk_sink<SysexSink>)
+    {
+        if (m_invoke_callbacks)
+        {
+            m_sysex_callback(sysex7_chunk{ format, m_sysex.manufacturerID, m_sysex.data.data(), m_sysex.data.size() });
+        }
+    }
+
+    m_sysex.data.clear();
+    m_sysex_chunk_sent = true;
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::sysex_continue_packet(uint8_t byte)
+{
+    // SysEx as packets
+    m_packet.set_byte(m_packet_byte, byte);
+    if (++m_packet_byte == 8)
+    {
+        m_packet.set_byte(1, (m_packet.status() & 0xF0) + 6);
+        post_packet(m_packet);
+
+        m_packet      = make_sysex7_continue_packet(m_group);
+        m_packet_byte = 2;
+    }
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::sysex_continue_packet(const uint8_t* begin,
+                                                                                  const uint8_t* end)
+{
+    while (begin != end)
+    {
+        const auto n = std::min(size_t(8 - m_packet_byte), size_t(end - begin));
+        for (size_t b = 0; b < n; ++b)
+            m_packet.set_byte(m_packet_byte++, *begin++);
+
+        if (m_packet_byte == 8)
+        {
+            m_packet.set_byte(1, (m_packet.status() & 0xF0) + 6);
+            post_packet(m_packet);
+
+            m_packet      = make_sysex7_continue_packet(m_group);
+            m_packet_byte = 2;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, typename SysexSink>
+void basic_midi1_byte_stream_parser<PacketSink, SysexSink>::sysex_end_packet()
+{
+    const auto cur_sysex_status = uint8_t(m_packet.status() & 0xF0);
+    const auto cur_packet_size  = uint8_t((m_packet_byte - 2) & 0x0F);
+
+    if (cur_sysex_status == data_status::sysex7_start)
+    {
+        if (m_packet_byte < 3)
+        {
+            // no manufacturer, useless
+            m_packet = universal_packet{};
+            return;
+        }
+
+        m_packet.set_byte(1, data_status::sysex7_complete + cur_packet_size);
+    }
+    else
+    {
+        m_packet.set_byte(1, data_status::sysex7_end + cur_packet_size);
+    }
+
+    post_packet(m_packet);
+
+    m_packet      = universal_packet{};
+    m_packet_byte = 2;
+}
+
+//--------------------------------------------------------------------------
+
 constexpr size_t midi1_byte_stream_size(const universal_packet& p)
 {
     switch (p.type())
@@ -0,0 +1,347 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/data_message.h>
+#include <midi/midi1_byte_stream.h>
+#include <midi/system_message.h>
+#include <midi/types.h>
+#include <midi/universal_packet.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! MIDI 1 byte stream parser for multiple ports sharing a single packet sink
+/*! Parses interleaved byte chunks of up to `NumPorts` independent MIDI 1 byte streams,
+    e.g. the ports of a multi port DIN interface. Each port is mapped to a group, by
+    default port `n` is mapped to group `n % 16`. The parser state of all ports is kept
+    in compact per port arrays, thus a single parser replaces `NumPorts` instances of
+    `midi1_byte_stream_parser`.
+
+    Parsed packets are passed to `PacketSink`, SysEx messages are delivered as `sysex7`
+    packets. The parsed packets are identical to the ones of a `midi1_byte_stream_parser`
+    without SysEx callback. */
+template<typename PacketSink, size_t NumPorts = 16>
+class basic_midi1_multiport_parser
+{
+  public:
+    using packet_callback = PacketSink;
+
+    static constexpr size_t num_ports = NumPorts;
+
+    explicit basic_midi1_multiport_parser(packet_callback);
+
+    group_t port_group(size_t port) const;
+    void    set_port_group(size_t port, group_t);
+
+    void feed(size_t port, uint8_t);
+    void feed(size_t port, const uint8_t* data, size_t num_bytes);
+    void feed(size_t port, const uint8_t* begin, const uint8_t* end);
+
+    void reset();
+    void reset(size_t port);
+
+  protected:
+    void status_byte(size_t port, uint8_t);
+    void sysex_data(size_t port, const uint8_t* begin, const uint8_t* end);
+    void sysex_end(size_t port);
+
+  private:
+    packet_callback m_packet_callback;
+
+    // per port parser state
+    uint8_t m_group[NumPorts];        //!< group of the port
+    uint8_t m_status[NumPorts];       //!< running status, system common status or 0xF0 during SysEx
+    uint8_t m_sysex_status[NumPorts]; //!< data status of the next sysex7 packet
+    uint8_t m_num_expected[NumPorts]; //!< number of data bytes of the current message
+    uint8_t m_num_bytes[NumPorts];    //!< number of collected data bytes
+    uint8_t m_bytes[NumPorts][6];     //!< collected data bytes
+};
+
+//--------------------------------------------------------------------------
+
+using midi1_multiport_parser = basic_midi1_multiport_parser<std::function<void(universal_packet)>>;
+
+extern template class basic_midi1_multiport_parser<std::function<void(universal_packet)>>;
+
+//--------------------------------------------------------------------------
+// implementation
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, size_t NumPorts>
+basic_midi1_multiport_parser<PacketSink, NumPorts>::basic_midi1_multiport_parser(packet_callback pcb)
+  : m_packet_callback(std::move(pcb))
+{
+    for (size_t port = 0; port < NumPorts; ++port)
+        m_group[port] = uint8_t(port & 0x0F);
+
+    reset();
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, size_t NumPorts>
+group_t basic_midi1_multiport_parser<PacketSink, NumPorts>::port_group(size_t port) const
+{
+    assert(port < NumPorts);
+    return m_group[port];
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, size_t NumPorts>
+void basic_midi1_multiport_parser<PacketSink, NumPorts>::set_port_group(size_t port, group_t group)
+{
+    assert(port < NumPorts);
+    assert(group < 16);
+    m_group[port] = group & 0x0F;
+}
+
+//--------------------------------------------------------------------------
+//! reset the parser state of all ports, the port groups are kept
+template<typename PacketSink, size_t NumPorts>
+void basic_midi1_multiport_parser<PacketSink, NumPorts>::reset()
+{
+    for (size_t port = 0; port < NumPorts; ++port)
+        reset(port);
+}
+
+//--------------------------------------------------------------------------
+//! reset the parser state of a port, the port group is kept
+template<typename PacketSink, size_t NumPorts>
+void basic_midi1_multiport_parser<PacketSink, NumPorts>::reset(size_t port)
+{
+    assert(port < NumPorts);
+
+    m_status[port]       = 0;
+    m_sysex_status[port] = data_status::sysex7_start;
+    m_num_expected[port] = 0;
+    m_num_bytes[port]    = 0;
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, size_t NumPorts>
+void basic_midi1_multiport_parser<PacketSink, NumPorts>::feed(size_t port, uint8_t byte)
+{
+    assert(port < NumPorts);
+
+    if (byte >= system_status::clock) // realtime messages
+    {
+        if ((byte == 0xF9) || (byte == 0xFD))
+            // undefined
+            return;
+
+        m_packet_callback(universal_packet{ 0x10000000u | (uint32_t(m_group[port]) << 24) | (uint32_t(byte) << 16) });
+        return;
+    }
+
+    if (m_status[port] == 0xF0) // SysEx in progress?
+    {
+        if (byte < 0x80) // SysEx data
+        {
+            sysex_data(port, &byte, &byte + 1);
+            return;
+        }
+        else if (byte == 0xF7) // end of SysEx
+        {
+            sysex_end(port);
+            return;
+        }
+
+        // cancel invalid SysEx message
+        reset(port);
+    }
+
+    if (byte >= 0x80)
+    {
+        status_byte(port, byte);
+    }
+    else if (m_num_expected[port])
+    {
+        m_bytes[port][m_num_bytes[port]++] = byte;
+        if (m_num_bytes[port] == m_num_expected[port])
+        {
+            const auto type = (m_status[port] < 0xF0) ? 0x20000000u : 0x10000000u;
+            m_packet_callback(universal_packet{ type | (uint32_t(m_group[port]) << 24) |
+                                                (uint32_t(m_status[port]) << 16) | (uint32_t(m_bytes[port][0]) << 8) |
+                                                ((m_num_bytes[port] > 1) ? m_bytes[port][1] : 0u) });
+
+            m_num_bytes[port] = 0;
+
+            if (m_status[port] >= 0xF0)
+            {
+                // cancel running status on SystemCommon messages
+                reset(port);
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, size_t NumPorts>
+void basic_midi1_multiport_parser<PacketSink, NumPorts>::feed(size_t port, const uint8_t* data, size_t num_bytes)
+{
+    feed(port, data, data + num_bytes);
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, size_t NumPorts>
+void basic_midi1_multiport_parser<PacketSink, NumPorts>::feed(size_t port, const uint8_t* begin, const uint8_t* end)
+{
+    assert(port < NumPorts);
+
+    while (begin < end)
+    {
+        if (m_status[port] == 0xF0) // SysEx in progress?
+        {
+            // process runs of SysEx data bytes in bulk
+            const auto* run_end = impl::find_status_byte(begin, end);
+            if (run_end != begin)
+            {
+                sysex_data(port, begin, run_end);
+                begin = run_end;
+                continue;
+            }
+        }
+
+        feed(port, *begin++);
+    }
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, size_t NumPorts>
+void basic_midi1_multiport_parser<PacketSink, NumPorts>::status_byte(size_t port, uint8_t byte)
+{
+    reset(port);
+
+    if (byte < 0xF0) // channel voice message
+    {
+        const auto status    = byte & 0xF0;
+        m_status[port]       = byte;
+        m_num_expected[port] = ((status == midi1_channel_voice_status::program_change) ||
+                                (status == midi1_channel_voice_status::channel_pressure))
+                                 ? 1
+                                 : 2;
+        return;
+    }
+
+    switch (byte)
+    {
+    case 0xF0: // SysEx start
+        m_status[port] = byte;
+        break;
+    case system_status::mtc_quarter_frame:
+    case system_status::song_select:
+        m_status[port]       = byte;
+        m_num_expected[port] = 1;
+        break;
+    case system_status::song_position:
+        m_status[port]       = byte;
+        m_num_expected[port] = 2;
+        break;
+    case system_status::tune_request:
+        m_packet_callback(universal_packet{ 0x10000000u | (uint32_t(m_group[port]) << 24) | (uint32_t(byte) << 16) });
+        break;
+    default:
+        // undefined, skip, cancel running status
+        break;
+    }
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, size_t NumPorts>
+void basic_midi1_multiport_parser<PacketSink, NumPorts>::sysex_data(size_t        port,
+                                                                    const uint8_t* begin,
+                                                                    const uint8_t* end)
+{
+    auto* bytes = m_bytes[port];
+    auto  n     = m_num_bytes[port];
+
+    while (begin != end)
+    {
+        const auto num_copied = std::min(size_t(6 - n), size_t(end - begin));
+        for (size_t b = 0; b < num_copied; ++b)
+            bytes[n++] = *begin++;
+
+        if (n == 6)
+        {
+            m_packet_callback(universal_packet{
+              0x30000000u | (uint32_t(m_group[port]) << 24) | (uint32_t(m_sysex_status[port] + 6) << 16) |
+                (uint32_t(bytes[0]) << 8) | bytes[1],
+              (uint32_t(bytes[2]) << 24) | (uint32_t(bytes[3]) << 16) | (uint32_t(bytes[4]) << 8) | bytes[5] });
+
+            m_sysex_status[port] = data_status::sysex7_continue;
+            n                    = 0;
+        }
+    }
+
+    m_num_bytes[port] = n;
+}
+
+//--------------------------------------------------------------------------
+
+template<typename PacketSink, size_t NumPorts>
+void basic_midi1_multiport_parser<PacketSink, NumPorts>::sysex_end(size_t port)
+{
+    const auto n = m_num_bytes[port];
+
+    // a SysEx message without manufacturer is useless
+    if ((m_sysex_status[port] == data_status::sysex7_continue) || (n > 0))
+    {
+        const auto status = (m_sysex_status[port] == data_status::sysex7_start) ? data_status::sysex7_complete
+                                                                                : data_status::sysex7_end;
+
+        uint8_t bytes[6] = {};
+        std::copy(m_bytes[port], m_bytes[port] + n, bytes);
+
+        m_packet_callback(
+          universal_packet{ 0x30000000u | (uint32_t(m_group[port]) << 24) | (uint32_t(status + n) << 16) |
+                              (uint32_t(bytes[0]) << 8) | bytes[1],
+                            (uint32_t(bytes[2]) << 24) | (uint32_t(bytes[3]) << 16) | (uint32_t(bytes[4]) << 8) |
+                              bytes[5] });
+    }
+
+    reset(port);
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
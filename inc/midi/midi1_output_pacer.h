@@ -0,0 +1,153 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/stream_message.h>
+#include <midi/types.h>
+#include <midi/universal_packet.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! true if a function block requires its MIDI 1 output to be restricted to 31.25 kbps
+constexpr bool requires_midi1_pacing(const function_block_options& options)
+{
+    return options.midi1 == function_block_options::midi1_31250;
+}
+
+//--------------------------------------------------------------------------
+//! Schedules timestamped UMPs for a 31.25 kbps MIDI 1 output
+/*! Packets become due at their timestamp (in microseconds) and are released by `poll()`
+    when the wire is free, each byte occupying the wire for `byte_duration_us`. Among due
+    packets, realtime messages are sent first, then note messages, then controller
+    messages (control change, program change, pressure, pitch bend), then SysEx and all
+    other messages. Packets of the same priority keep their order, thus they should be
+    pushed in timestamp order. Packets without MIDI 1 byte stream representation do not
+    occupy the wire.
+
+    With controller thinning enabled, a controller message replaces a queued message of the
+    same group, channel and controller that is held back, i.e. was due at the last `poll()`
+    or is behind the time the wire becomes free, so a backed up queue only sends the latest
+    value. The replaced message keeps its place in the queue and its earlier due time.
+    Messages scheduled for the future and program changes are never replaced. */
+class midi1_output_pacer
+{
+  public:
+    enum class priority : uint8_t {
+        realtime   = 0,
+        note       = 1,
+        controller = 2,
+        sysex      = 3, //!< SysEx and all other messages
+    };
+
+    static constexpr uint32_t byte_duration_us = 320; //!< 10 bits per byte at 31250 baud
+    static constexpr size_t   num_priorities   = 4;
+
+    explicit midi1_output_pacer(size_t max_queued_packets = 1024);
+
+    bool controller_thinning_enabled() const { return m_controller_thinning; }
+    void enable_controller_thinning(bool enable) { m_controller_thinning = enable; }
+
+    //! queue a packet, returns false if the queue is full
+    bool push(const universal_packet&, uint64_t timestamp_us);
+
+    //! release all packets that can be sent until `now_us`, `sink` is invoked with packet and send time
+    template<typename Sink>
+    size_t poll(uint64_t now_us, Sink&&);
+
+    //! earliest time a queued packet can be sent, `UINT64_MAX` if the queue is empty
+    uint64_t next_send_time() const;
+
+    //! time at which the wire is free again
+    uint64_t wire_free_time() const { return m_wire_free; }
+
+    size_t size() const;
+    bool   empty() const { return size() == 0; }
+    size_t capacity() const { return m_capacity; }
+
+    void clear();
+
+    static priority packet_priority(const universal_packet&);
+    static size_t   wire_size(const universal_packet&);
+
+  private:
+    struct entry
+    {
+        uint64_t         timestamp;
+        universal_packet packet;
+    };
+
+    bool               thin(const universal_packet&, uint64_t timestamp_us);
+    std::deque<entry>* next_due(uint64_t now_us);
+
+    std::deque<entry> m_queues[num_priorities];
+    size_t            m_capacity;
+    uint64_t          m_wire_free{ 0 };
+    uint64_t          m_now{ 0 }; //!< time of the last poll()
+    bool              m_controller_thinning{ false };
+};
+
+//--------------------------------------------------------------------------
+// implementation
+//--------------------------------------------------------------------------
+
+template<typename Sink>
+size_t midi1_output_pacer::poll(uint64_t now_us, Sink&& sink)
+{
+    size_t result = 0;
+
+    m_now = std::max(m_now, now_us);
+
+    while (m_wire_free <= now_us)
+    {
+        auto* queue = next_due(now_us);
+        if (!queue)
+            break;
+
+        const auto e         = queue->front();
+        const auto send_time = std::max(m_wire_free, e.timestamp);
+        queue->pop_front();
+
+        m_wire_free = send_time + wire_size(e.packet) * byte_duration_us;
+
+        sink(e.packet, send_time);
+        ++result;
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
@@ -0,0 +1,215 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/data_message.h>
+#include <midi/extended_data_message.h>
+#include <midi/flex_data_message.h>
+#include <midi/midi1_channel_voice_message.h>
+#include <midi/midi2_channel_voice_message.h>
+#include <midi/stream_message.h>
+#include <midi/system_message.h>
+#include <midi/types.h>
+#include <midi/universal_packet.h>
+#include <midi/utility_message.h>
+
+//--------------------------------------------------------------------------
+
+#include <type_traits>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! Route a packet to the matching overload of a handler
+/*! The handler is any callable, typically a struct with overloaded `operator()` or
+    an overload set of lambdas, accepting one or more of these views:
+
+        utility_message_view, system_message_view,
+        midi1_channel_voice_message_view, midi2_channel_voice_message_view,
+        sysex7_packet_view, sysex8_packet_view, flex_data_message_view,
+        endpoint_discovery_view, endpoint_info_view, device_identity_view,
+        endpoint_name_view, product_instance_id_view, stream_configuration_view,
+        function_block_discovery_view, function_block_info_view, function_block_name_view
+
+    Packets without a matching overload are passed as `const universal_packet&` if the
+    handler accepts it and are silently dropped otherwise.
+
+    The routing table is built at compile time from the handler's overload set, so
+    dispatching costs one indexed call per packet (two for stream messages). */
+template<typename Handler>
+void dispatch(const universal_packet&, Handler&&);
+
+template<typename Handler>
+void dispatch(const universal_packet* packets, size_t num_packets, Handler&&);
+
+//--------------------------------------------------------------------------
+// template implementations
+//--------------------------------------------------------------------------
+
+namespace impl {
+
+    template<typename Handler>
+    using dispatch_function = void (*)(const universal_packet&, Handler&);
+
+    template<typename Handler>
+    void dispatch_fallback(const universal_packet& p, Handler& handler)
+    {
+        if constexpr (std::is_invocable_v<Handler&, const universal_packet&>)
+            handler(p);
+        else
+            (void)p, (void)handler;
+    }
+
+    template<typename View, typename Handler>
+    void dispatch_view(const universal_packet& p, Handler& handler)
+    {
+        if constexpr (std::is_invocable_v<Handler&, View>)
+            handler(View{ p });
+        else
+            dispatch_fallback(p, handler);
+    }
+
+    template<typename Handler>
+    void dispatch_sysex7(const universal_packet& p, Handler& handler)
+    {
+        if (is_sysex7_packet(p))
+            dispatch_view<sysex7_packet_view>(p, handler);
+        else
+            dispatch_fallback(p, handler);
+    }
+
+    template<typename Handler>
+    void dispatch_sysex8(const universal_packet& p, Handler& handler)
+    {
+        if (is_sysex8_packet(p))
+            dispatch_view<sysex8_packet_view>(p, handler);
+        else
+            dispatch_fallback(p, handler);
+    }
+
+    template<typename Handler>
+    struct stream_dispatch_table
+    {
+        static constexpr size_t num_entries = 0x20;
+
+        static constexpr dispatch_function<Handler> entries[num_entries] = {
+            dispatch_view<endpoint_discovery_view, Handler>,       // 0x00
+            dispatch_view<endpoint_info_view, Handler>,            // 0x01
+            dispatch_view<device_identity_view, Handler>,          // 0x02
+            dispatch_view<endpoint_name_view, Handler>,            // 0x03
+            dispatch_view<product_instance_id_view, Handler>,      // 0x04
+            dispatch_view<stream_configuration_view, Handler>,     // 0x05
+            dispatch_view<stream_configuration_view, Handler>,     // 0x06
+            dispatch_fallback<Handler>,                            // 0x07
+            dispatch_fallback<Handler>,                            // 0x08
+            dispatch_fallback<Handler>,                            // 0x09
+            dispatch_fallback<Handler>,                            // 0x0A
+            dispatch_fallback<Handler>,                            // 0x0B
+            dispatch_fallback<Handler>,                            // 0x0C
+            dispatch_fallback<Handler>,                            // 0x0D
+            dispatch_fallback<Handler>,                            // 0x0E
+            dispatch_fallback<Handler>,                            // 0x0F
+            dispatch_view<function_block_discovery_view, Handler>, // 0x10
+            dispatch_view<function_block_info_view, Handler>,      // 0x11
+            dispatch_view<function_block_name_view, Handler>,      // 0x12
+            dispatch_fallback<Handler>,                            // 0x13
+            dispatch_fallback<Handler>,                            // 0x14
+            dispatch_fallback<Handler>,                            // 0x15
+            dispatch_fallback<Handler>,                            // 0x16
+            dispatch_fallback<Handler>,                            // 0x17
+            dispatch_fallback<Handler>,                            // 0x18
+            dispatch_fallback<Handler>,                            // 0x19
+            dispatch_fallback<Handler>,                            // 0x1A
+            dispatch_fallback<Handler>,                            // 0x1B
+            dispatch_fallback<Handler>,                            // 0x1C
+            dispatch_fallback<Handler>,                            // 0x1D
+            dispatch_fallback<Handler>,                            // 0x1E
+            dispatch_fallback<Handler>,                            // 0x1F
+        };
+    };
+
+    template<typename Handler>
+    void dispatch_stream(const universal_packet& p, Handler& handler)
+    {
+        const auto status = (p.data[0] >> 16u) & 0x3FF; // 10 bit stream status
+        if (status < stream_dispatch_table<Handler>::num_entries)
+            stream_dispatch_table<Handler>::entries[status](p, handler);
+        else
+            dispatch_fallback(p, handler);
+    }
+
+    template<typename Handler>
+    struct packet_dispatch_table
+    {
+        static constexpr dispatch_function<Handler> entries[16] = {
+            dispatch_view<utility_message_view, Handler>,             // 0x0
+            dispatch_view<system_message_view, Handler>,              // 0x1
+            dispatch_view<midi1_channel_voice_message_view, Handler>, // 0x2
+            dispatch_sysex7<Handler>,                                 // 0x3
+            dispatch_view<midi2_channel_voice_message_view, Handler>, // 0x4
+            dispatch_sysex8<Handler>,                                 // 0x5
+            dispatch_fallback<Handler>,                               // 0x6
+            dispatch_fallback<Handler>,                               // 0x7
+            dispatch_fallback<Handler>,                               // 0x8
+            dispatch_fallback<Handler>,                               // 0x9
+            dispatch_fallback<Handler>,                               // 0xA
+            dispatch_fallback<Handler>,                               // 0xB
+            dispatch_fallback<Handler>,                               // 0xC
+            dispatch_view<flex_data_message_view, Handler>,           // 0xD
+            dispatch_fallback<Handler>,                               // 0xE
+            dispatch_stream<Handler>,                                 // 0xF
+        };
+    };
+
+} // namespace impl
+
+//--------------------------------------------------------------------------
+
+template<typename Handler>
+void dispatch(const universal_packet& p, Handler&& handler)
+{
+    using handler_t = std::remove_reference_t<Handler>;
+
+    impl::packet_dispatch_table<handler_t>::entries[p.data[0] >> 28u](p, handler);
+}
+
+//--------------------------------------------------------------------------
+
+template<typename Handler>
+void dispatch(const universal_packet* packets, size_t num_packets, Handler&& handler)
+{
+    using handler_t = std::remove_reference_t<Handler>;
+
+    for (size_t i = 0; i < num_packets; ++i)
+        impl::packet_dispatch_table<handler_t>::entries[packets[i].data[0] >> 28u](packets[i], handler);
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
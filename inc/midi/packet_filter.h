@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/types.h>
+#include <midi/universal_packet.h>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! Packet filter based on packet type, group, status and channel
+/*! The rule set is compiled into a bit table indexed by the upper 12 bits of the
+    first packet word (packet type, group and upper status nibble), each entry holding
+    a mask of the accepted lower status nibbles, i.e. channels for channel voice
+    messages. Thus testing a packet is a single table lookup and bit test.
+
+    For packet types without channel the channel mask applies to the lower nibble of
+    the status byte, for groupless packets the group mask applies to the corresponding
+    bits of the first word.
+
+    A default constructed filter rejects all packets. */
+class packet_filter
+{
+  public:
+    static constexpr uint16_t all = 0xFFFF;
+
+    static constexpr uint16_t group_mask(group_t g) { return uint16_t(1u << (g & 0x0F)); }
+    static constexpr uint16_t channel_mask(channel_t c) { return uint16_t(1u << (c & 0x0F)); }
+    static constexpr uint16_t status_mask(status_t s) { return uint16_t(1u << (s >> 4)); }
+
+    packet_filter() = default;
+
+    packet_filter& accept(packet_type, uint16_t groups = all, uint16_t statuses = all, uint16_t channels = all);
+    packet_filter& reject(packet_type, uint16_t groups = all, uint16_t statuses = all, uint16_t channels = all);
+
+    packet_filter& accept_all();
+    packet_filter& reject_all();
+
+    bool accepts(uint32_t first_word) const
+    {
+        return (m_masks[first_word >> 20u] >> ((first_word >> 16u) & 0x0F)) & 1u;
+    }
+    bool accepts(const universal_packet& p) const { return accepts(p.data[0]); }
+
+    size_t apply(const universal_packet* packets, size_t num_packets, universal_packet* out) const;
+    size_t apply(const uint32_t* words, size_t num_words, uint32_t* out) const;
+
+  private:
+    uint16_t m_masks[4096]{};
+};
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
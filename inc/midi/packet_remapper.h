@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/types.h>
+#include <midi/universal_packet.h>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! Rewrites groups and channels of packets in place
+/*! Channel voice messages (MIDI 1, MIDI 2 and channel addressed flex data) are
+    remapped using a 16x16 group / channel table, all other packets with a group
+    field, including group addressed flex data, using a group table. Groupless
+    utility and stream messages as well as reserved packet types are left untouched.
+
+    Both tables are compiled into a single lookup table indexed by packet type,
+    group and channel, so remapping a packet is one table lookup without branches.
+
+    A default constructed remapper does not modify any packets. */
+class packet_remapper
+{
+  public:
+    packet_remapper();
+
+    void map_group(group_t from, group_t to);
+    void map_channel(group_t from_group, channel_t from_channel, group_t to_group, channel_t to_channel);
+    void reset();
+
+    group_t   group_for(group_t) const;
+    group_t   group_for(group_t, channel_t) const;
+    channel_t channel_for(group_t, channel_t) const;
+
+    uint32_t remap(uint32_t first_word) const
+    {
+        // group addressed flex data has its own table section behind the packet types
+        const bool flex_group = ((first_word & 0xF0000000u) == 0xD0000000u) && (first_word & 0x00300000u);
+        const auto type_key   = flex_group ? 0x1000u : ((first_word >> 20u) & 0xF00);
+        const auto key        = type_key | ((first_word >> 20u) & 0x0F0) | ((first_word >> 16u) & 0x0F);
+        const auto gc         = m_table[key];
+        return (first_word & 0xF0F0FFFFu) | (uint32_t(gc & 0xF0) << 20u) | (uint32_t(gc & 0x0F) << 16u);
+    }
+
+    void   apply(universal_packet& p) const { p.data[0] = remap(p.data[0]); }
+    void   apply(universal_packet* packets, size_t num_packets) const;
+    size_t apply(uint32_t* words, size_t num_words) const;
+
+  private:
+    void update(group_t);
+
+    uint8_t m_group_map[16];     //!< new group per group
+    uint8_t m_channel_map[256];  //!< new group / channel per group / channel
+    uint8_t m_table[4096 + 256]; //!< new group / channel (status nibble) per packet type / group / channel,
+                                 //!< followed by group addressed flex data
+};
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
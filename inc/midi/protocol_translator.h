@@ -0,0 +1,180 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/types.h>
+#include <midi/universal_packet.h>
+
+#include <cstddef>
+#include <cstdint>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! Stateful MIDI 2 to MIDI 1 protocol translator
+/*! Translates MIDI 2 channel voice messages to MIDI 1 channel voice messages, all other
+    packets are passed unchanged. In addition to `as_midi1_channel_voice_message()`:
+    - registered / assignable controllers are sent as RPN / NRPN sequences, the parameter
+      number is only sent if it differs from the one last selected on the channel
+    - program change with bank valid is preceded by bank select MSB / LSB
+    - note attributes are dropped instead of dropping the note
+
+    Per note controllers, per note pitch bend, per note management and relative controllers
+    have no MIDI 1 equivalent and are dropped. A single packet results in at most
+    `max_packets_per_packet` packets. */
+class midi2_to_midi1_translator
+{
+  public:
+    static constexpr size_t max_packets_per_packet = 4;
+
+    midi2_to_midi1_translator();
+
+    //! translate a packet, passing resulting packets to `sink`
+    template<typename Sink>
+    void translate(const universal_packet&, Sink&&);
+
+    //! translate a packet, returns the number of packets written to `out`
+    size_t translate(const universal_packet&, universal_packet out[max_packets_per_packet]);
+
+    //! translate packets into `out`, which needs room for `num_packets * max_packets_per_packet` packets
+    /*! Returns the number of packets written. If `num_out` is given, it receives the number of
+        packets written for each of the `num_packets` packets (0 if dropped, > 1 if expanded). */
+    size_t translate(const universal_packet* packets,
+                     size_t                  num_packets,
+                     universal_packet*       out,
+                     uint8_t*                num_out = nullptr);
+
+    //! forget the selected parameter numbers, e.g. after the receiver was reconnected
+    void reset();
+
+  private:
+    uint16_t m_parameter[256]; //!< selected RPN / NRPN per group and channel
+};
+
+//--------------------------------------------------------------------------
+//! Stateful MIDI 1 to MIDI 2 protocol translator
+/*! Translates MIDI 1 channel voice messages to MIDI 2 channel voice messages, all other
+    packets are passed unchanged. In addition to `as_midi2_channel_voice_message()`,
+    the translator keeps a fixed size state per group and channel:
+    - RPN / NRPN selection (CC 101/100, CC 99/98) and data entry (CC 6/38) are translated
+      to registered / assignable controller messages, a data entry MSB is sent with its
+      7 bit value, a following LSB resends the combined 14 bit value
+    - bank select (CC 0/32) is attached to following program change messages
+    - for controllers 1..31 the LSB (CC 33..63) resends the controller with the combined
+      14 bit value, an LSB without preceding MSB is translated as is
+
+    Data entry without selected parameter and RPN null are dropped. A single packet
+    results in at most `max_packets_per_packet` packets. */
+class midi1_to_midi2_translator
+{
+  public:
+    static constexpr size_t max_packets_per_packet = 1;
+
+    midi1_to_midi2_translator();
+
+    //! translate a packet, passing resulting packets to `sink`
+    template<typename Sink>
+    void translate(const universal_packet&, Sink&&);
+
+    //! translate a packet, returns the number of packets written to `out`
+    size_t translate(const universal_packet&, universal_packet out[max_packets_per_packet]);
+
+    //! translate packets into `out`, which needs room for `num_packets` packets
+    /*! Returns the number of packets written. If `num_out` is given, it receives the number of
+        packets written for each of the `num_packets` packets (0 if dropped). */
+    size_t translate(const universal_packet* packets,
+                     size_t                  num_packets,
+                     universal_packet*       out,
+                     uint8_t*                num_out = nullptr);
+
+    void reset();
+
+  private:
+    size_t translate_control_change(const universal_packet&, universal_packet& out);
+
+    // per group and channel state, 0x80 if unknown
+    uint8_t m_bank_msb[256];
+    uint8_t m_bank_lsb[256];
+    uint8_t m_parameter_type[256]; //!< control_change::rpn_lsb, control_change::nrpn_lsb or 0
+    uint8_t m_parameter_msb[256];
+    uint8_t m_parameter_lsb[256];
+    uint8_t m_data_entry_msb[256];
+    uint8_t m_controller_msb[256][32]; //!< MSB of controllers 1..31
+};
+
+//--------------------------------------------------------------------------
+//! Stateless bulk MIDI 1 to MIDI 2 channel voice message conversion
+/*! Converts MIDI 1 channel voice messages like `as_midi2_channel_voice_message()`, packets
+    that cannot be converted are dropped, all other packets are passed unchanged. Packets
+    are processed in blocks, value upscaling is done for a whole block at once.
+    `out` needs room for `num_packets` packets, returns the number of packets written.
+    If `num_out` is given, it receives the number of packets written for each packet (0 or 1). */
+size_t convert_midi1_to_midi2(const universal_packet* packets,
+                              size_t                  num_packets,
+                              universal_packet*       out,
+                              uint8_t*                num_out = nullptr);
+
+//--------------------------------------------------------------------------
+//! Stateless bulk MIDI 2 to MIDI 1 channel voice message conversion
+/*! Counterpart of `convert_midi1_to_midi2()`, converts MIDI 2 channel voice messages like
+    `as_midi1_channel_voice_message()`. */
+size_t convert_midi2_to_midi1(const universal_packet* packets,
+                              size_t                  num_packets,
+                              universal_packet*       out,
+                              uint8_t*                num_out = nullptr);
+
+//--------------------------------------------------------------------------
+// implementation
+//--------------------------------------------------------------------------
+
+template<typename Sink>
+void midi2_to_midi1_translator::translate(const universal_packet& p, Sink&& sink)
+{
+    universal_packet packets[max_packets_per_packet];
+
+    const auto num_packets = translate(p, packets);
+    for (size_t i = 0; i < num_packets; ++i)
+        sink(packets[i]);
+}
+
+//--------------------------------------------------------------------------
+
+template<typename Sink>
+void midi1_to_midi2_translator::translate(const universal_packet& p, Sink&& sink)
+{
+    universal_packet packets[max_packets_per_packet];
+
+    const auto num_packets = translate(p, packets);
+    for (size_t i = 0; i < num_packets; ++i)
+        sink(packets[i]);
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
@@ -0,0 +1,182 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/jitter_reduction_timestamps.h>
+#include <midi/types.h>
+#include <midi/universal_packet.h>
+
+#include <algorithm>
+#include <cassert>
+#include <optional>
+#include <vector>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! UMP with a Jitter Reduction timestamp
+struct timed_packet
+{
+    jr_timestamp_t   timestamp;
+    universal_packet packet;
+};
+
+//--------------------------------------------------------------------------
+//! merges time ordered streams of timed packets into a single time ordered stream
+/*! Uses a binary heap of stream cursors, so merging n packets of k streams costs O(n log k).
+    Packets with equal timestamps are delivered in the order the streams were added.
+
+    Timestamp comparison handles the wrap-around of 16 bit JR timestamps, it requires
+    that the pending packets of all streams are less than half the timestamp range
+    (about one second) apart. The merger does not copy packets, streams must stay
+    valid until they are consumed. */
+class timed_packet_merger
+{
+  public:
+    timed_packet_merger() = default;
+
+    void add_stream(const timed_packet* begin, const timed_packet* end);
+    void add_stream(const timed_packet* packets, size_t num_packets);
+    void clear();
+
+    bool   empty() const { return m_heap.empty(); }
+    size_t num_active_streams() const { return m_heap.size(); }
+
+    std::optional<timed_packet> next();
+
+    size_t merge(timed_packet* out, size_t max_packets);
+
+    template<typename Sink>
+    size_t merge(Sink&&);
+
+  private:
+    struct cursor
+    {
+        const timed_packet* pos;
+        const timed_packet* end;
+        size_t              stream;
+    };
+
+    //! heap order, the earliest packet is at the front
+    static bool is_later(const cursor& a, const cursor& b)
+    {
+        if (a.pos->timestamp == b.pos->timestamp)
+            return a.stream > b.stream;
+        return is_earlier(b.pos->timestamp, a.pos->timestamp);
+    }
+
+    const timed_packet& pop();
+
+    std::vector<cursor> m_heap;
+    size_t              m_num_streams{ 0 };
+};
+
+//--------------------------------------------------------------------------
+
+inline void timed_packet_merger::add_stream(const timed_packet* begin, const timed_packet* end)
+{
+    assert(begin <= end);
+
+    const auto stream = m_num_streams++;
+    if (begin != end)
+    {
+        m_heap.push_back(cursor{ begin, end, stream });
+        std::push_heap(m_heap.begin(), m_heap.end(), is_later);
+    }
+}
+
+//--------------------------------------------------------------------------
+
+inline void timed_packet_merger::add_stream(const timed_packet* packets, size_t num_packets)
+{
+    add_stream(packets, packets + num_packets);
+}
+
+//--------------------------------------------------------------------------
+
+inline void timed_packet_merger::clear()
+{
+    m_heap.clear();
+    m_num_streams = 0;
+}
+
+//--------------------------------------------------------------------------
+
+inline const timed_packet& timed_packet_merger::pop()
+{
+    assert(!m_heap.empty());
+
+    std::pop_heap(m_heap.begin(), m_heap.end(), is_later);
+
+    auto&       c      = m_heap.back();
+    const auto& result = *c.pos++;
+    if (c.pos == c.end)
+        m_heap.pop_back();
+    else
+        std::push_heap(m_heap.begin(), m_heap.end(), is_later);
+
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+inline std::optional<timed_packet> timed_packet_merger::next()
+{
+    if (m_heap.empty())
+        return std::nullopt;
+    return pop();
+}
+
+//--------------------------------------------------------------------------
+//! write up to max_packets merged packets into out, returns the number of packets written
+inline size_t timed_packet_merger::merge(timed_packet* out, size_t max_packets)
+{
+    size_t result = 0;
+    while ((result < max_packets) && !m_heap.empty())
+        out[result++] = pop();
+    return result;
+}
+
+//--------------------------------------------------------------------------
+//! pass all remaining packets in time order to sink, returns the number of packets
+template<typename Sink>
+size_t timed_packet_merger::merge(Sink&& sink)
+{
+    size_t result = 0;
+    while (!m_heap.empty())
+    {
+        sink(pop());
+        ++result;
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
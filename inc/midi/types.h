@@ -73,6 +73,11 @@ constexpr uint32_t upsample_14_to_32bit(uint14_t);
 
 constexpr uint32_t upsample_x_to_ybit(uint32_t v, uint8_t x, uint8_t y);
 
+// bulk versions, branch free so that the compiler can vectorize them
+constexpr void downsample_32_to_7bit(const uint32_t* in, size_t num_values, uint7_t* out);
+constexpr void upsample_7_to_32bit(const uint7_t* in, size_t num_values, uint32_t* out);
+constexpr void upsample_14_to_32bit(const uint14_t* in, size_t num_values, uint32_t* out);
+
 //--------------------------------------------------------------------------
 
 struct velocity
@@ -479,6 +484,42 @@ constexpr uint32_t upsample_14_to_32bit(uint14_t v)
 
 //--------------------------------------------------------------------------
 
+constexpr void downsample_32_to_7bit(const uint32_t* in, size_t num_values, uint7_t* out)
+{
+    for (size_t i = 0; i < num_values; ++i)
+        out[i] = uint7_t(in[i] >> 25u);
+}
+
+//--------------------------------------------------------------------------
+
+constexpr void upsample_7_to_32bit(const uint7_t* in, size_t num_values, uint32_t* out)
+{
+    for (size_t i = 0; i < num_values; ++i)
+    {
+        const uint32_t v    = in[i] & 0x7F;
+        uint32_t       bits = (v & 0x3F);
+        bits |= (bits << 6); // 12 bits
+        // bit repeat only above center, masked instead of branched
+        const uint32_t repeat_mask = 0u - uint32_t(v > 64);
+        out[i] = (v << 25u) | (((bits << 13u) | (bits << 1) | (bits >> 11u)) & repeat_mask);
+    }
+}
+
+//--------------------------------------------------------------------------
+
+constexpr void upsample_14_to_32bit(const uint14_t* in, size_t num_values, uint32_t* out)
+{
+    for (size_t i = 0; i < num_values; ++i)
+    {
+        const uint32_t v           = in[i] & 0x3FFF;
+        const uint32_t bits        = v & 0x1FFF; // 13 bits
+        const uint32_t repeat_mask = 0u - uint32_t(v > 8192);
+        out[i]                     = (v << 18u) | (((bits << 5u) | (bits >> 8u)) & repeat_mask);
+    }
+}
+
+//--------------------------------------------------------------------------
+
 constexpr uint32_t upsample_x_to_ybit(uint32_t v, uint8_t x, uint8_t y)
 {
     assert((x > 1) && (y <= 32) && (x < y));
@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/types.h>
+#include <midi/ump_stream.h>
+#include <midi/universal_packet.h>
+
+#include <cassert>
+#include <vector>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! container storing UMPs back to back with their actual size
+/*! Compared to a container of `universal_packet` a 32 bit packet only occupies four instead
+    of 16 bytes. Random access requires an optional offset index that costs four bytes per packet. */
+class ump_buffer
+{
+  public:
+    using iterator       = ump_stream_view::iterator;
+    using const_iterator = iterator;
+
+    ump_buffer() = default;
+    explicit ump_buffer(bool with_index);
+
+    void   push_back(const universal_packet&);
+    size_t append(const uint32_t* words, size_t num_words);
+
+    void clear();
+    void reserve(size_t num_words);
+
+    bool   empty() const { return m_num_packets == 0; }
+    size_t size() const { return m_num_packets; }
+    size_t size_in_words() const { return m_words.size(); }
+
+    const uint32_t* data() const { return m_words.data(); }
+
+    ump_stream_view view() const { return { m_words.data(), m_words.size() }; }
+    iterator        begin() const { return view().begin(); }
+    iterator        end() const { return view().end(); }
+
+    bool has_index() const { return m_has_index; }
+    void enable_index(bool);
+
+    ump_packet_view  operator[](size_t) const;
+    universal_packet packet(size_t) const;
+
+  private:
+    std::vector<uint32_t> m_words;
+    std::vector<uint32_t> m_offsets;
+    size_t                m_num_packets{ 0 };
+    bool                  m_has_index{ false };
+};
+
+//--------------------------------------------------------------------------
+
+inline ump_buffer::ump_buffer(bool with_index)
+  : m_has_index(with_index)
+{
+}
+
+//--------------------------------------------------------------------------
+
+inline void ump_buffer::push_back(const universal_packet& p)
+{
+    if (m_has_index)
+        m_offsets.push_back(uint32_t(m_words.size()));
+
+    m_words.insert(m_words.end(), p.data, p.data + p.size());
+    ++m_num_packets;
+}
+
+//--------------------------------------------------------------------------
+//! append complete packets from a word buffer, returns the number of words appended
+inline size_t ump_buffer::append(const uint32_t* words, size_t num_words)
+{
+    const auto first_offset = m_words.size();
+
+    ump_stream_view s{ words, num_words };
+    size_t          num_appended = 0;
+    for (auto it = s.begin(); it != s.end(); ++it)
+    {
+        if (m_has_index)
+            m_offsets.push_back(uint32_t(first_offset + size_t(it.position() - words)));
+        num_appended += (*it).size();
+        ++m_num_packets;
+    }
+
+    m_words.insert(m_words.end(), words, words + num_appended);
+    return num_appended;
+}
+
+//--------------------------------------------------------------------------
+
+inline void ump_buffer::clear()
+{
+    m_words.clear();
+    m_offsets.clear();
+    m_num_packets = 0;
+}
+
+//--------------------------------------------------------------------------
+
+inline void ump_buffer::reserve(size_t num_words)
+{
+    m_words.reserve(num_words);
+}
+
+//--------------------------------------------------------------------------
+
+inline void ump_buffer::enable_index(bool enable)
+{
+    m_offsets.clear();
+
+    if (enable)
+    {
+        m_offsets.reserve(m_num_packets);
+        for (auto it = begin(); it != end(); ++it)
+            m_offsets.push_back(uint32_t(it.position() - m_words.data()));
+    }
+    else
+    {
+        m_offsets.shrink_to_fit();
+    }
+
+    m_has_index = enable;
+}
+
+//--------------------------------------------------------------------------
+
+inline ump_packet_view ump_buffer::operator[](size_t index) const
+{
+    assert(m_has_index); // random access requires an index
+    assert(index < m_num_packets);
+    return ump_packet_view{ m_words.data() + m_offsets[index] };
+}
+
+//--------------------------------------------------------------------------
+
+inline universal_packet ump_buffer::packet(size_t index) const
+{
+    return operator[](index).packet();
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
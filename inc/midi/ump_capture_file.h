@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/jitter_reduction_timestamps.h>
+#include <midi/types.h>
+#include <midi/ump_stream.h>
+
+#include <cstdio>
+#include <vector>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! Packed UMP capture file format
+/*! A capture file starts with a 16 byte header:
+
+        'U' 'M' 'P' 'C' <version> 0x00 0x00 0x00 <byte order mark> 0x00 0x00 0x00 0x00
+
+    followed by the packet words stored back to back in the byte order of the
+    capturing host. The 32 bit byte order mark 0x01020304 allows the reader to
+    reject files captured on a host with a different byte order. */
+constexpr size_t  ump_capture_header_size    = 16;
+constexpr uint8_t ump_capture_format_version = 1;
+
+size_t write_ump_capture_header(uint8_t* out, size_t out_size);
+bool   write_ump_capture_header(std::FILE*);
+
+//--------------------------------------------------------------------------
+//! read-only memory-mapped view of a packed UMP capture file
+/*! The file is mapped into memory, packets are not copied or loaded up front.
+    Packets are framed using their packet size, a trailing packet or word that
+    was not completely written is reported by `is_truncated()` and excluded
+    from `packets()`. */
+class ump_capture_file
+{
+  public:
+    ump_capture_file() = default;
+    ~ump_capture_file();
+
+    ump_capture_file(const ump_capture_file&)            = delete;
+    ump_capture_file& operator=(const ump_capture_file&) = delete;
+    ump_capture_file(ump_capture_file&&) noexcept;
+    ump_capture_file& operator=(ump_capture_file&&) noexcept;
+
+    bool open(const char* path);
+    void close();
+
+    bool is_open() const { return m_data != nullptr; }
+
+    ump_stream_view packets() const { return ump_stream_view{ words(), m_num_words }; }
+    size_t          size_in_words() const { return m_num_words; }
+
+    bool   is_truncated() const { return (m_num_trailing_bytes != 0) || (num_truncated_words() != 0); }
+    size_t num_truncated_words() const { return packets().num_incomplete_words(); }
+    size_t num_trailing_bytes() const { return m_num_trailing_bytes; }
+
+    //! time index entry, ticks are relative to the first JR timestamp in the file
+    struct time_index_entry
+    {
+        jr_ticks ticks;
+        size_t   word_offset;
+    };
+
+    void                                 build_time_index(jr_ticks interval = jr_ticks{ jr_clock_frequency });
+    const std::vector<time_index_entry>& time_index() const { return m_time_index; }
+
+    ump_stream_view packets_from(jr_ticks) const;
+
+  private:
+    const uint32_t* words() const;
+
+    void*  m_data{ nullptr }; //!< mapped file including header
+    size_t m_size{ 0 };       //!< mapped size in bytes
+    size_t m_num_words{ 0 };
+    size_t m_num_trailing_bytes{ 0 };
+
+#ifdef _WIN32
+    void* m_file{ nullptr };
+    void* m_mapping{ nullptr };
+#endif
+
+    std::vector<time_index_entry> m_time_index;
+};
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
@@ -0,0 +1,124 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/types.h>
+#include <midi/universal_packet.h>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! bounded lock-free multiple producer / single consumer queue of UMPs
+/*! Merges packets of many producers (e.g. endpoints) into a single consumer thread.
+    Every entry carries the id of its source and a sequence number that is counted
+    per producer, so the consumer can keep track of the origin and order of packets.
+    The capacity (in packets) is rounded up to the next power of two.
+
+    Producers push either via a `producer` handle (one handle per producer thread),
+    or directly via `try_push(entry)`. `try_pop()` may only be called from a single
+    consumer thread. Neither allocates memory nor locks. */
+class ump_mpsc_queue
+{
+  public:
+    struct entry
+    {
+        universal_packet packet;
+        uint16_t         source{ 0 };   //!< id of the producer
+        uint32_t         sequence{ 0 }; //!< per producer sequence number
+    };
+
+    class producer
+    {
+      public:
+        bool try_push(const universal_packet&);
+
+        uint16_t source() const { return m_source; }
+        uint32_t next_sequence() const { return m_sequence; }
+
+      private:
+        friend class ump_mpsc_queue;
+
+        producer(ump_mpsc_queue& queue, uint16_t source)
+          : m_queue(&queue)
+          , m_source(source)
+        {
+        }
+
+        ump_mpsc_queue* m_queue;
+        uint16_t        m_source;
+        uint32_t        m_sequence{ 0 };
+    };
+
+    explicit ump_mpsc_queue(size_t capacity);
+
+    ump_mpsc_queue(const ump_mpsc_queue&)            = delete;
+    ump_mpsc_queue& operator=(const ump_mpsc_queue&) = delete;
+
+    size_t capacity() const { return m_mask + 1; }
+
+    producer make_producer(uint16_t source) { return producer{ *this, source }; }
+
+    // producers
+    bool try_push(const entry&);
+
+    // consumer
+    std::optional<entry> try_pop();
+
+  private:
+    struct cell
+    {
+        std::atomic<size_t> sequence{ 0 };
+        entry               data;
+    };
+
+    const size_t            m_mask;
+    std::unique_ptr<cell[]> m_cells;
+
+    alignas(64) std::atomic<size_t> m_enqueue_index{ 0 };
+    alignas(64) size_t m_dequeue_index{ 0 };
+};
+
+//--------------------------------------------------------------------------
+
+inline bool ump_mpsc_queue::producer::try_push(const universal_packet& p)
+{
+    if (!m_queue->try_push(entry{ p, m_source, m_sequence }))
+        return false;
+
+    ++m_sequence;
+    return true;
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
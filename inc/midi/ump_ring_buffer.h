@@ -0,0 +1,87 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/types.h>
+#include <midi/universal_packet.h>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! wait-free single producer / single consumer queue of UMPs
+/*! Packets are stored by word with their actual size, a packet is never split across
+    the end of the ring buffer. The capacity (in 32 bit words) is rounded up to the next
+    power of two, minimum capacity is eight words.
+
+    `try_push()` and `write()` may only be called from a single producer thread,
+    `try_pop()` and `read()` only from a single consumer thread. Neither allocates
+    memory nor locks. */
+class ump_ring_buffer
+{
+  public:
+    explicit ump_ring_buffer(size_t capacity_in_words);
+
+    ump_ring_buffer(const ump_ring_buffer&)            = delete;
+    ump_ring_buffer& operator=(const ump_ring_buffer&) = delete;
+
+    size_t capacity() const { return m_mask + 1; }
+
+    // producer
+    bool   try_push(const universal_packet&);
+    size_t write(const uint32_t* words, size_t num_words);
+
+    // consumer
+    std::optional<universal_packet> try_pop();
+    size_t                          read(uint32_t* words, size_t max_words);
+
+    bool empty() const;
+
+  private:
+    size_t free_words(size_t write_index, size_t needed);
+    size_t available_words(size_t read_index);
+    size_t reserve_packet(size_t write_index, size_t packet_size);
+    size_t skip_padding(size_t read_index) const;
+
+    const size_t                m_mask;
+    std::unique_ptr<uint32_t[]> m_words;
+
+    alignas(64) std::atomic<size_t> m_write_index{ 0 };
+    size_t m_cached_read_index{ 0 }; //!< producer's copy of the read index
+
+    alignas(64) std::atomic<size_t> m_read_index{ 0 };
+    size_t m_cached_write_index{ 0 }; //!< consumer's copy of the write index
+};
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
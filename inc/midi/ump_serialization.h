@@ -0,0 +1,131 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/types.h>
+#include <midi/universal_packet.h>
+
+#include <cstdio>
+#include <optional>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! Binary UMP record format
+/*! A binary UMP stream starts with an optional 8 byte header:
+
+        'U' 'M' 'P' 'B' <version> <flags> 0x00 0x00
+
+    followed by records, each consisting of
+
+        <number of words (1..4)> [64 bit timestamp] <words>
+
+    Timestamps and words are stored in the byte order given by the format. */
+enum class byte_order : uint8_t
+{
+    little_endian = 0,
+    big_endian    = 1
+};
+
+struct ump_record_format
+{
+    byte_order order{ byte_order::little_endian };
+    bool       with_timestamps{ false };
+
+    constexpr size_t record_size(const universal_packet& p) const
+    {
+        return 1 + (with_timestamps ? 8 : 0) + p.size() * 4;
+    }
+    constexpr size_t max_record_size() const { return 1 + (with_timestamps ? 8 : 0) + 16; }
+
+    constexpr bool operator==(const ump_record_format& o) const
+    {
+        return (order == o.order) && (with_timestamps == o.with_timestamps);
+    }
+    constexpr bool operator!=(const ump_record_format& o) const { return !operator==(o); }
+};
+
+constexpr size_t  ump_record_header_size    = 8;
+constexpr uint8_t ump_record_format_version = 1;
+
+//--------------------------------------------------------------------------
+
+size_t                           write_ump_record_header(const ump_record_format&, uint8_t* out, size_t out_size);
+std::optional<ump_record_format> read_ump_record_header(const uint8_t* in, size_t in_size);
+
+//--------------------------------------------------------------------------
+//! Serialize packets into a buffer
+/*! Writes complete records only and stops at the first record that does not fit.
+    `timestamps` is only used if the format has timestamps, it may be `nullptr` to
+    write zero timestamps. Returns the number of bytes written, `num_written`
+    receives the number of packets written. */
+size_t write_ump_records(const ump_record_format&,
+                         const universal_packet* packets,
+                         const uint64_t*         timestamps,
+                         size_t                  num_packets,
+                         uint8_t*                out,
+                         size_t                  out_size,
+                         size_t&                 num_written);
+
+//! Deserialize packets from a buffer
+/*! Reads complete records only and stops at the first incomplete or invalid record,
+    nothing is stored for that record. `timestamps` may be `nullptr` to skip timestamps.
+    Returns the number of bytes consumed, which is the offset of the first record not
+    read, `num_read` receives the number of packets read. */
+size_t read_ump_records(const ump_record_format&,
+                        const uint8_t*    in,
+                        size_t            in_size,
+                        universal_packet* packets,
+                        uint64_t*         timestamps,
+                        size_t            max_packets,
+                        size_t&           num_read);
+
+//--------------------------------------------------------------------------
+
+bool                             write_ump_record_header(std::FILE*, const ump_record_format&);
+std::optional<ump_record_format> read_ump_record_header(std::FILE*);
+
+//! Write packets to a file, returns the number of packets written
+size_t write_ump_records(std::FILE*,
+                         const ump_record_format&,
+                         const universal_packet* packets,
+                         const uint64_t*         timestamps,
+                         size_t                  num_packets);
+
+//! Read packets from a file, returns the number of packets read
+/*! Stops at the end of the file or at the first incomplete or invalid record, nothing is
+    stored for that record. The file is left positioned at the start of the rejected record,
+    so reading can be resumed once more data is available. For non seekable streams only
+    the word count byte of an invalid count is pushed back. */
+size_t read_ump_records(
+  std::FILE*, const ump_record_format&, universal_packet* packets, uint64_t* timestamps, size_t max_packets);
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
@@ -0,0 +1,245 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/types.h>
+#include <midi/universal_packet.h>
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! non-owning view of a single UMP stored in a buffer of 32 bit words
+struct ump_packet_view
+{
+    constexpr explicit ump_packet_view(const uint32_t* words)
+      : w(words)
+    {
+        assert(words != nullptr);
+    }
+
+    constexpr packet_type type() const { return static_cast<packet_type>((w[0] >> 28u) & 0x0F); }
+    constexpr size_t      size() const { return packet_size(type()); }
+
+    constexpr group_t  group() const { return ((w[0] >> 24u) & 0x0F); }
+    constexpr status_t status() const { return byte2(); }
+
+    constexpr uint8_t byte2() const { return ((w[0] >> 16u) & 0xFF); }
+    constexpr uint8_t byte3() const { return ((w[0] >> 8u) & 0xFF); }
+    constexpr uint8_t byte4() const { return (w[0] & 0xFF); }
+
+    constexpr uint8_t get_byte(size_t b) const;
+    constexpr uint7_t get_byte_7bit(size_t b) const { return get_byte(b) & 0x7F; }
+
+    constexpr bool has_channel() const
+    {
+        return type() == packet_type::midi1_channel_voice || type() == packet_type::midi2_channel_voice ||
+               type() == packet_type::flex_data;
+    }
+    constexpr channel_t channel() const
+    {
+        assert(has_channel());
+        return byte2() & 0x0F;
+    }
+
+    constexpr const uint32_t* data() const { return w; }
+    constexpr uint32_t        operator[](size_t word) const
+    {
+        assert(word < size());
+        return w[word];
+    }
+
+    constexpr universal_packet packet() const;
+
+    constexpr bool operator==(const universal_packet& p) const { return packet() == p; }
+    constexpr bool operator!=(const universal_packet& p) const { return !operator==(p); }
+
+  private:
+    const uint32_t* w;
+};
+
+//--------------------------------------------------------------------------
+//! non-owning view of a sequence of UMPs stored back to back in a buffer of 32 bit words
+/*! Packets are framed using the size of their packet type. A trailing packet that
+    is not completely contained in the buffer is not part of the sequence. */
+class ump_stream_view
+{
+  public:
+    class iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = ump_packet_view;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = ump_packet_view;
+
+        constexpr iterator() = default;
+
+        constexpr ump_packet_view operator*() const { return ump_packet_view{ m_pos }; }
+
+        constexpr iterator& operator++();
+        constexpr iterator  operator++(int)
+        {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        constexpr bool operator==(const iterator& o) const { return m_pos == o.m_pos; }
+        constexpr bool operator!=(const iterator& o) const { return m_pos != o.m_pos; }
+
+        constexpr const uint32_t* position() const { return m_pos; }
+
+      private:
+        friend class ump_stream_view;
+
+        constexpr iterator(const uint32_t* pos, const uint32_t* end)
+          : m_pos(pos)
+          , m_end(end)
+        {
+            skip_incomplete();
+        }
+
+        constexpr void skip_incomplete()
+        {
+            if ((m_pos != m_end) && (size_t(m_end - m_pos) < packet_size(packet_type((*m_pos >> 28u) & 0x0F))))
+                m_pos = m_end;
+        }
+
+        const uint32_t* m_pos{ nullptr };
+        const uint32_t* m_end{ nullptr };
+    };
+
+    using const_iterator = iterator;
+
+    constexpr ump_stream_view() = default;
+    constexpr ump_stream_view(const uint32_t* words, size_t num_words)
+      : m_words(words)
+      , m_num_words(num_words)
+    {
+        assert(words || !num_words);
+    }
+
+    constexpr iterator begin() const { return iterator{ m_words, m_words + m_num_words }; }
+    constexpr iterator end() const { return iterator{ m_words + m_num_words, m_words + m_num_words }; }
+
+    constexpr bool empty() const { return begin() == end(); }
+
+    constexpr const uint32_t* data() const { return m_words; }
+    constexpr size_t          size_in_words() const { return m_num_words; }
+
+    constexpr size_t num_packets() const;
+    constexpr size_t num_incomplete_words() const;
+
+  private:
+    const uint32_t* m_words{ nullptr };
+    size_t          m_num_words{ 0 };
+};
+
+//--------------------------------------------------------------------------
+//! Classify all complete packets in a buffer of UMP words in a single batch
+/*! Writes the word offset of each packet into `offsets`, followed by the total number of
+    words consumed (prefix sum of the packet sizes), thus `offsets` must provide room
+    for `max_packets + 1` entries. `types` and `groups` are optional and receive the packet
+    type and group of each packet. Returns the number of packets classified. */
+size_t classify_packets(const uint32_t* words,
+                        size_t          num_words,
+                        uint32_t*       offsets,
+                        packet_type*    types,
+                        group_t*        groups,
+                        size_t          max_packets);
+
+//--------------------------------------------------------------------------
+// constexpr implementations
+//--------------------------------------------------------------------------
+
+constexpr uint8_t ump_packet_view::get_byte(size_t b) const
+{
+    assert(b < size() * 4); // invalid byte
+
+    const auto word  = b / 4;
+    const auto byte  = b % 4;
+    const auto shift = (3 - byte) * 8;
+
+    return (w[word] >> shift) & 0xFF;
+}
+
+//--------------------------------------------------------------------------
+
+constexpr universal_packet ump_packet_view::packet() const
+{
+    universal_packet result;
+    const auto       len = size();
+    for (auto i = 0u; i < len; ++i)
+        result.data[i] = w[i];
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+constexpr ump_stream_view::iterator& ump_stream_view::iterator::operator++()
+{
+    assert(m_pos != m_end);
+    m_pos += packet_size(packet_type((*m_pos >> 28u) & 0x0F));
+    skip_incomplete();
+    return *this;
+}
+
+//--------------------------------------------------------------------------
+
+constexpr size_t ump_stream_view::num_packets() const
+{
+    size_t result = 0;
+    for (auto it = begin(); it != end(); ++it)
+        ++result;
+    return result;
+}
+
+//--------------------------------------------------------------------------
+//! number of words at the end of the buffer that do not form a complete packet
+constexpr size_t ump_stream_view::num_incomplete_words() const
+{
+    size_t pos = 0;
+    while (pos < m_num_words)
+    {
+        const auto len = packet_size(packet_type((m_words[pos] >> 28u) & 0x0F));
+        if (pos + len > m_num_words)
+            break;
+        pos += len;
+    }
+    return m_num_words - pos;
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
@@ -28,6 +28,7 @@
 
 #include <cassert>
 #include <iosfwd>
+#include <system_error>
 
 //--------------------------------------------------------------------------
 
@@ -317,6 +318,10 @@ namespace registered_per_note_controller {
     constexpr controller_t effects_5_depth   = 95;
 } // namespace registered_per_note_controller
 
+//--------------------------------------------------------------------------
+//! number of 32 bit words of a packet of a given type
+constexpr size_t packet_size(packet_type);
+
 //--------------------------------------------------------------------------
 //! Universal MIDI packet
 struct universal_packet
@@ -419,11 +424,18 @@ constexpr void universal_packet::set_group(group_t c)
 
 //--------------------------------------------------------------------------
 
-constexpr size_t universal_packet::size() const
+constexpr size_t packet_size(packet_type type)
 {
     constexpr size_t size_lookup[16] = { 1, 1, 1, 2, 2, 4, 1, 1, 2, 2, 2, 3, 3, 4, 4, 4 };
 
-    return size_lookup[static_cast<unsigned>(type())];
+    return size_lookup[static_cast<unsigned>(type) & 0x0F];
+}
+
+//--------------------------------------------------------------------------
+
+constexpr size_t universal_packet::size() const
+{
+    return packet_size(type());
 }
 
 //--------------------------------------------------------------------------
@@ -529,6 +541,36 @@ std::istream& operator>>(std::istream&, universal_packet&);
 
 //--------------------------------------------------------------------------
 
+//! maximum number of characters written by to_chars() for a single packet
+constexpr size_t max_packet_chars = 4 * 8 + 3;
+
+//! result of to_chars(), members as in `std::to_chars_result`
+struct to_chars_result
+{
+    char*     ptr;
+    std::errc ec;
+};
+
+//! result of from_chars(), members as in `std::from_chars_result`
+struct from_chars_result
+{
+    const char* ptr;
+    std::errc   ec;
+};
+
+//! format packet words as eight lower case hex digits separated by a space
+/*! Same as operator<< on a stream without formatting flags like `std::uppercase`. */
+to_chars_result to_chars(char* first, char* last, const universal_packet&);
+//! format multiple packets into one buffer, each packet is followed by `separator`
+to_chars_result to_chars(
+  char* first, char* last, const universal_packet* packets, size_t num_packets, char separator = '\n');
+
+//! parse packet words of up to eight hex digits separated by spaces or tabs
+/*! The number of words is determined by the type of the first word. */
+from_chars_result from_chars(const char* first, const char* last, universal_packet&);
+
+//--------------------------------------------------------------------------
+
 } // namespace midi
 
 //--------------------------------------------------------------------------
@@ -0,0 +1,355 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+//--------------------------------------------------------------------------
+
+#include <midi/data_message.h>
+#include <midi/system_message.h>
+#include <midi/types.h>
+#include <midi/universal_packet.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+//! USB MIDI 1.0 event packet
+/*! Memory layout matches the four bytes of an event packet on the USB bus, the cable
+    number maps to the UMP group. */
+struct usb_midi1_event
+{
+    uint8_t header{ 0 };        //!< cable number (high nibble) and code index number (low nibble)
+    uint8_t midi[3]{ 0, 0, 0 }; //!< MIDI 1 bytes, unused bytes are zero
+
+    constexpr uint4_t cable() const { return header >> 4; }
+    constexpr uint4_t code_index() const { return header & 0x0F; }
+
+    constexpr bool operator==(const usb_midi1_event& o) const
+    {
+        return (header == o.header) && (midi[0] == o.midi[0]) && (midi[1] == o.midi[1]) && (midi[2] == o.midi[2]);
+    }
+    constexpr bool operator!=(const usb_midi1_event& o) const { return !operator==(o); }
+};
+
+static_assert(sizeof(usb_midi1_event) == 4, "usb_midi1_event must match the USB event packet size");
+
+//--------------------------------------------------------------------------
+
+constexpr usb_midi1_event make_usb_midi1_event(
+  uint4_t cable, uint4_t code_index, uint8_t b0, uint8_t b1 = 0, uint8_t b2 = 0)
+{
+    return usb_midi1_event{ uint8_t((cable << 4) | (code_index & 0x0F)), { b0, b1, b2 } };
+}
+
+//--------------------------------------------------------------------------
+//! number of MIDI 1 bytes carried by an event packet with the given code index number
+constexpr size_t usb_midi1_event_size(uint4_t code_index)
+{
+    constexpr uint8_t sizes[16] = { 0, 0, 2, 3, 3, 1, 2, 3, 3, 3, 3, 3, 2, 2, 3, 1 };
+    return sizes[code_index & 0x0F];
+}
+
+//--------------------------------------------------------------------------
+//! Converts USB MIDI 1.0 event packets to UMPs
+/*! Channel voice and system messages are converted statelessly, SysEx is reassembled
+    into `sysex7_packet`s separately for each cable. A single event results in at most
+    `max_packets_per_event` packets. Reserved code index numbers are ignored. */
+class usb_midi1_decoder
+{
+  public:
+    static constexpr size_t max_packets_per_event = 2;
+
+    //! convert events, passing resulting packets to `sink`
+    template<typename Sink>
+    void decode(const usb_midi1_event* events, size_t num_events, Sink&& sink);
+
+    //! convert events into `out`, which needs room for `num_events * max_packets_per_event` packets
+    /*! Returns the number of packets written. */
+    size_t decode(const usb_midi1_event* events, size_t num_events, universal_packet* out);
+
+    void reset();
+
+  private:
+    template<typename Sink>
+    void single_byte(uint4_t cable, uint8_t, Sink&&);
+    template<typename Sink>
+    void sysex_byte(uint4_t cable, uint8_t, Sink&&);
+
+    // per cable SysEx state
+    uint8_t m_sysex_status[16]{}; //!< data status of the next sysex7 packet, zero if no SysEx in progress
+    uint8_t m_num_bytes[16]{};    //!< number of collected SysEx bytes
+    uint8_t m_bytes[16][6]{};     //!< collected SysEx bytes
+};
+
+//--------------------------------------------------------------------------
+//! Converts UMPs to USB MIDI 1.0 event packets
+/*! Converts MIDI 1 channel voice, system and `sysex7` packets, the group maps to the
+    cable number. All other packets are ignored, use a protocol translator to convert
+    MIDI 2 channel voice messages first. As SysEx event packets always carry three bytes
+    unless the message ends, up to two bytes of an unfinished SysEx message are held
+    back per group until the next `sysex7` packet of that group arrives. A single packet
+    results in at most `max_events_per_packet` events. */
+class usb_midi1_encoder
+{
+  public:
+    static constexpr size_t max_events_per_packet = 3;
+
+    //! convert a packet, passing resulting events to `sink`
+    template<typename Sink>
+    void encode(const universal_packet&, Sink&&);
+
+    //! convert packets into `out`, which needs room for `num_packets * max_events_per_packet` events
+    /*! Returns the number of events written. */
+    size_t encode(const universal_packet* packets, size_t num_packets, usb_midi1_event* out);
+
+    void reset();
+
+  private:
+    uint8_t m_num_pending[16]{}; //!< number of held back SysEx bytes
+    uint8_t m_pending[16][2]{};  //!< held back SysEx bytes
+};
+
+//--------------------------------------------------------------------------
+// implementation
+//--------------------------------------------------------------------------
+
+template<typename Sink>
+void usb_midi1_decoder::decode(const usb_midi1_event* events, size_t num_events, Sink&& sink)
+{
+    assert(events || !num_events);
+
+    for (size_t e = 0; e < num_events; ++e)
+    {
+        const auto& event      = events[e];
+        const auto  cable      = event.cable();
+        const auto  code_index = event.code_index();
+        const auto  group      = uint32_t(cable) << 24;
+
+        switch (code_index)
+        {
+        case 0x8: // channel voice messages
+        case 0x9:
+        case 0xA:
+        case 0xB:
+        case 0xE:
+            sink(universal_packet{ 0x20000000u | group | (uint32_t(event.midi[0]) << 16) |
+                                   (uint32_t(event.midi[1]) << 8) | event.midi[2] });
+            break;
+        case 0xC:
+        case 0xD:
+            sink(universal_packet{ 0x20000000u | group | (uint32_t(event.midi[0]) << 16) |
+                                   (uint32_t(event.midi[1]) << 8) });
+            break;
+        case 0x2: // two byte system common
+            sink(universal_packet{ 0x10000000u | group | (uint32_t(event.midi[0]) << 16) |
+                                   (uint32_t(event.midi[1]) << 8) });
+            break;
+        case 0x3: // three byte system common
+            sink(universal_packet{ 0x10000000u | group | (uint32_t(event.midi[0]) << 16) |
+                                   (uint32_t(event.midi[1]) << 8) | event.midi[2] });
+            break;
+        case 0x4: // SysEx starts or continues
+        case 0x7: // SysEx ends with three bytes
+            sysex_byte(cable, event.midi[0], sink);
+            sysex_byte(cable, event.midi[1], sink);
+            sysex_byte(cable, event.midi[2], sink);
+            break;
+        case 0x6: // SysEx ends with two bytes
+            sysex_byte(cable, event.midi[0], sink);
+            sysex_byte(cable, event.midi[1], sink);
+            break;
+        case 0x5: // single byte system common or SysEx ends with one byte
+        case 0xF: // single byte
+            single_byte(cable, event.midi[0], sink);
+            break;
+        default: // reserved
+            break;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------
+
+template<typename Sink>
+void usb_midi1_decoder::single_byte(uint4_t cable, uint8_t byte, Sink&& sink)
+{
+    if ((byte >= system_status::clock) || (byte == system_status::tune_request))
+    {
+        if ((byte != 0xF9) && (byte != 0xFD)) // skip undefined
+            sink(universal_packet{ 0x10000000u | (uint32_t(cable) << 24) | (uint32_t(byte) << 16) });
+    }
+    else
+    {
+        sysex_byte(cable, byte, sink);
+    }
+}
+
+//--------------------------------------------------------------------------
+
+template<typename Sink>
+void usb_midi1_decoder::sysex_byte(uint4_t cable, uint8_t byte, Sink&& sink)
+{
+    auto& status = m_sysex_status[cable];
+    auto& n      = m_num_bytes[cable];
+    auto* bytes  = m_bytes[cable];
+
+    if (byte == 0xF0) // SysEx start, cancels any unfinished message
+    {
+        status = data_status::sysex7_start;
+        n      = 0;
+    }
+    else if (!status)
+    {
+        // no SysEx in progress, skip
+    }
+    else if (byte < 0x80) // SysEx data
+    {
+        bytes[n++] = byte;
+        if (n == 6)
+        {
+            sink(universal_packet{ 0x30000000u | (uint32_t(cable) << 24) | (uint32_t(status + 6) << 16) |
+                                     (uint32_t(bytes[0]) << 8) | bytes[1],
+                                   (uint32_t(bytes[2]) << 24) | (uint32_t(bytes[3]) << 16) |
+                                     (uint32_t(bytes[4]) << 8) | bytes[5] });
+
+            status = data_status::sysex7_continue;
+            n      = 0;
+        }
+    }
+    else // end of SysEx
+    {
+        // a SysEx message without manufacturer is useless
+        if ((byte == 0xF7) && ((status == data_status::sysex7_continue) || (n > 0)))
+        {
+            for (auto b = n; b < 6; ++b)
+                bytes[b] = 0;
+
+            const auto end_status =
+              (status == data_status::sysex7_start) ? data_status::sysex7_complete : data_status::sysex7_end;
+
+            sink(universal_packet{ 0x30000000u | (uint32_t(cable) << 24) | (uint32_t(end_status + n) << 16) |
+                                     (uint32_t(bytes[0]) << 8) | bytes[1],
+                                   (uint32_t(bytes[2]) << 24) | (uint32_t(bytes[3]) << 16) |
+                                     (uint32_t(bytes[4]) << 8) | bytes[5] });
+        }
+
+        status = 0;
+        n      = 0;
+    }
+}
+
+//--------------------------------------------------------------------------
+
+template<typename Sink>
+void usb_midi1_encoder::encode(const universal_packet& p, Sink&& sink)
+{
+    const auto cable  = p.group();
+    const auto status = p.status();
+
+    switch (p.type())
+    {
+    case packet_type::midi1_channel_voice:
+        sink(make_usb_midi1_event(cable, status >> 4, status, p.get_byte(2), p.get_byte(3)));
+        break;
+    case packet_type::system:
+        switch (status)
+        {
+        case system_status::mtc_quarter_frame:
+        case system_status::song_select:
+            sink(make_usb_midi1_event(cable, 0x2, status, p.get_byte(2)));
+            break;
+        case system_status::song_position:
+            sink(make_usb_midi1_event(cable, 0x3, status, p.get_byte(2), p.get_byte(3)));
+            break;
+        case system_status::tune_request:
+            sink(make_usb_midi1_event(cable, 0x5, status));
+            break;
+        default:
+            if (status >= system_status::clock)
+                sink(make_usb_midi1_event(cable, 0xF, status));
+            break;
+        }
+        break;
+    case packet_type::data:
+        if (is_sysex7_packet(p))
+        {
+            const auto format = status & 0xF0;
+            const auto size   = std::min(size_t(status & 0x0F), size_t(6));
+            const bool starts = (format == data_status::sysex7_complete) || (format == data_status::sysex7_start);
+            const bool ends   = (format == data_status::sysex7_complete) || (format == data_status::sysex7_end);
+
+            uint8_t bytes[9];
+            size_t  num_bytes = 0;
+            if (starts)
+            {
+                bytes[num_bytes++] = 0xF0; // drop bytes of an unfinished message
+            }
+            else
+            {
+                for (size_t b = 0; b < m_num_pending[cable]; ++b)
+                    bytes[num_bytes++] = m_pending[cable][b];
+            }
+            for (size_t b = 0; b < size; ++b)
+                bytes[num_bytes++] = p.get_byte(2 + b);
+            if (ends)
+                bytes[num_bytes++] = 0xF7;
+
+            size_t pos = 0;
+            for (; (pos + 3 < num_bytes) || (!ends && (pos + 3 == num_bytes)); pos += 3)
+                sink(make_usb_midi1_event(cable, 0x4, bytes[pos], bytes[pos + 1], bytes[pos + 2]));
+
+            const auto remaining = num_bytes - pos;
+            if (ends)
+            {
+                // SysEx ends with one, two or three bytes
+                sink(make_usb_midi1_event(cable,
+                                          uint4_t(0x4 + remaining),
+                                          bytes[pos],
+                                          (remaining > 1) ? bytes[pos + 1] : 0,
+                                          (remaining > 2) ? bytes[pos + 2] : 0));
+                m_num_pending[cable] = 0;
+            }
+            else
+            {
+                for (size_t b = 0; b < remaining; ++b)
+                    m_pending[cable][b] = bytes[pos + b];
+                m_num_pending[cable] = uint8_t(remaining);
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
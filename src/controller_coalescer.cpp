@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <midi/controller_coalescer.h>
+
+#include <cassert>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+
+namespace {
+
+    // controllers that are part of bank select, parameter or note sequences must not be dropped
+    constexpr bool is_sequence_controller(controller_t controller)
+    {
+        switch (controller)
+        {
+        case control_change::bank_select_msb:
+        case control_change::data_entry_msb:
+        case control_change::bank_select_lsb:
+        case control_change::data_entry_lsb:
+        case control_change::hi_res_velocity_prefix:
+        case control_change::data_increment:
+        case control_change::data_decrement:
+        case control_change::nrpn_lsb:
+        case control_change::nrpn_msb:
+        case control_change::rpn_lsb:
+        case control_change::rpn_msb:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // channel mode messages act on the whole channel like notes and are not coalesced either
+    constexpr bool is_coalesced_controller(controller_t controller)
+    {
+        return (controller < control_change::all_sound_off) && !is_sequence_controller(controller);
+    }
+
+} // namespace
+
+//--------------------------------------------------------------------------
+
+controller_coalescer::controller_coalescer(size_t max_pending_packets, uint64_t window_us)
+  : m_capacity(max_pending_packets)
+  , m_window(window_us)
+{
+    m_pending.reserve(max_pending_packets);
+}
+
+//--------------------------------------------------------------------------
+
+uint32_t controller_coalescer::coalescing_key(const universal_packet& p)
+{
+    // the key is the first packet word without the value bits, it is never 0
+    // as it includes the packet type
+    const auto word0 = p.data[0];
+
+    switch (p.type())
+    {
+    case packet_type::midi1_channel_voice:
+        switch (p.status() & 0xF0)
+        {
+        case channel_voice_status::poly_pressure:
+            return word0 & 0xFFFFFF00u;
+        case channel_voice_status::control_change:
+            return is_coalesced_controller(p.byte3()) ? (word0 & 0xFFFFFF00u) : 0;
+        case channel_voice_status::channel_pressure:
+        case channel_voice_status::pitch_bend:
+            return word0 & 0xFFFF0000u;
+        default:
+            return 0;
+        }
+    case packet_type::midi2_channel_voice:
+        switch (p.status() & 0xF0)
+        {
+        case channel_voice_status::registered_per_note_controller:
+        case channel_voice_status::assignable_per_note_controller:
+        case channel_voice_status::registered_controller:
+        case channel_voice_status::assignable_controller:
+            return word0;
+        case channel_voice_status::poly_pressure:
+        case channel_voice_status::per_note_pitch_bend:
+            return word0 & 0xFFFFFF00u;
+        case channel_voice_status::control_change:
+            return is_coalesced_controller(p.byte3()) ? (word0 & 0xFFFFFF00u) : 0;
+        case channel_voice_status::channel_pressure:
+        case channel_voice_status::pitch_bend:
+            return word0 & 0xFFFF0000u;
+        default:
+            return 0;
+        }
+    default:
+        return 0;
+    }
+}
+
+//--------------------------------------------------------------------------
+
+bool controller_coalescer::hold(uint32_t key, const universal_packet& p, uint64_t timestamp_us)
+{
+    assert(key != 0);
+
+    for (auto& e : m_pending)
+    {
+        if (e.key == key)
+        {
+            // keeps the position and time of the first arrival
+            e.packet = p;
+            return true;
+        }
+    }
+
+    if (m_pending.size() >= m_capacity)
+        return false;
+
+    m_pending.push_back(entry{ key, timestamp_us, p });
+    return true;
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
@@ -0,0 +1,158 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <midi/endpoint_protocol_adapter.h>
+
+#include <midi/stream_message.h>
+
+#include <cassert>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+
+endpoint_protocol_adapter::endpoint_protocol_adapter(protocol_t p, extensions_t e)
+  : m_protocol(p)
+  , m_extensions(e)
+  , m_midi1_groups(0)
+  , m_function_block_groups()
+{
+}
+
+//--------------------------------------------------------------------------
+
+bool endpoint_protocol_adapter::process_endpoint_packet(const universal_packet& p)
+{
+    if (!is_stream_message(p))
+        return false;
+
+    if (p.status() == stream_status::stream_configuration_notify)
+    {
+        const stream_configuration_view m{ p };
+        if ((m.protocol() != protocol::midi1) && (m.protocol() != protocol::midi2))
+            return false;
+
+        if ((m.protocol() == m_protocol) && (m.extensions() == m_extensions))
+            return false;
+
+        if (m.protocol() != m_protocol)
+            reset();
+
+        m_protocol   = m.protocol();
+        m_extensions = m.extensions();
+        return true;
+    }
+
+    if (const auto m = as_function_block_info_view(p))
+    {
+        if (m->function_block() >= max_function_blocks)
+            return false;
+
+        uint16_t groups = 0;
+        if (m->active() && (m->midi1() != function_block_options::not_midi1))
+        {
+            for (uint8_t g = m->first_group(); (g < 16) && (g < m->first_group() + m->num_groups_spanned()); ++g)
+                groups |= uint16_t(1u << g);
+        }
+        m_function_block_groups[m->function_block()] = groups;
+
+        uint16_t midi1_groups = 0;
+        for (const auto block_groups : m_function_block_groups)
+            midi1_groups |= block_groups;
+
+        if (midi1_groups == m_midi1_groups)
+            return false;
+
+        m_midi1_groups = midi1_groups;
+        if (m_protocol == protocol::midi2)
+            reset();
+        return true;
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------
+
+protocol_t endpoint_protocol_adapter::group_protocol(group_t group) const
+{
+    if ((m_protocol == protocol::midi2) && !(m_midi1_groups & (1u << (group & 0x0F))))
+        return protocol::midi2;
+
+    return protocol::midi1;
+}
+
+//--------------------------------------------------------------------------
+
+size_t endpoint_protocol_adapter::adapt(const universal_packet& p, universal_packet out[max_packets_per_packet])
+{
+    switch (p.type())
+    {
+    case packet_type::midi1_channel_voice:
+        if (group_protocol(p.group()) == protocol::midi2)
+            return m_to_midi2.translate(p, out);
+        break;
+    case packet_type::midi2_channel_voice:
+        if (group_protocol(p.group()) == protocol::midi1)
+            return m_to_midi1.translate(p, out);
+        break;
+    case packet_type::utility:
+        if (((p.status() == utility_status::jr_clock) || (p.status() == utility_status::jr_timestamp)) &&
+            !(m_extensions & extensions::jitter_reduction_receive))
+            return 0;
+        break;
+    default:
+        break;
+    }
+
+    out[0] = p;
+    return 1;
+}
+
+//--------------------------------------------------------------------------
+
+size_t endpoint_protocol_adapter::adapt(const universal_packet* packets, size_t num_packets, universal_packet* out)
+{
+    assert(packets || !num_packets);
+    assert(out || !num_packets);
+
+    size_t result = 0;
+    for (size_t i = 0; i < num_packets; ++i)
+        result += adapt(packets[i], out + result);
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+void endpoint_protocol_adapter::reset()
+{
+    m_to_midi1.reset();
+    m_to_midi2.reset();
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
@@ -22,379 +22,137 @@
 
 #include <midi/midi1_byte_stream.h>
 
-#include <midi/data_message.h>
-#include <midi/midi1_channel_voice_message.h>
-#include <midi/system_message.h>
-
 //--------------------------------------------------------------------------
 
 namespace midi {
 
 //--------------------------------------------------------------------------
 
-void midi1_byte_stream_parser::feed(uint8_t byte)
-{
-    if (byte >= system_status::clock) // realtime messages
-    {
-        system_realtime(byte);
-        return;
-    }
-
-    if (m_packet.type() == packet_type::data) // SysEx in progress?
-    {
-        if (byte < 0x80) // SysEx data
-        {
-            if (has_sysex_callback()) // SysEx callbacks enabled?
-            {
-                sysex_continue_callback(byte);
-            }
-            else
-            {
-                sysex_continue_packet(byte);
-            }
-
-            return;
-        }
-        else // end of SysEx
-        {
-            if (byte != 0xF7) // cancel invalid SysEx message
-            {
-                m_packet = universal_packet{};
-            }
-            else // end of SysEx
-            {
-                if (has_sysex_callback()) // SysEx callbacks enabled?
-                {
-                    sysex_end_callback();
-                }
-                else
-                {
-                    sysex_end_packet();
-                }
-
-                return;
-            }
-        }
-    }
-
-    if (byte == 0xF0) // SysEx start
-    {
-        sysex_start();
-    }
-    else if (byte > 0xF0) // System Common
-    {
-        system_common(byte);
-    }
-    else if (byte >= 0x80) // channel voice message
-    {
-        channel_voice(byte);
-    }
-    else if (m_packet.status() && m_num_missing_bytes && (m_packet_byte < 4))
-    {
-        m_packet.set_byte(m_packet_byte, byte);
-        --m_num_missing_bytes;
-        if (m_num_missing_bytes == 0)
-        {
-            // handle running status
-            if (m_packet.status() < 0xF0)
-            {
-                m_num_missing_bytes = m_packet_byte - 1;
-                m_packet_byte       = 2;
-            }
-
-            // post packet
-            if (m_invoke_callbacks)
-            {
-                m_packet_callback(m_packet);
-            }
-
-            if (m_packet.status() >= 0xF0)
-            {
-                // cancel running status on SystemCommon messages
-                m_packet = universal_packet{};
-            }
-        }
-        else
-        {
-            ++m_packet_byte;
-        }
-    }
-}
-
-//--------------------------------------------------------------------------
-
-void midi1_byte_stream_parser::feed(const uint8_t* begin, const uint8_t* end)
-{
-    for (const auto* it = begin; it < end; ++it)
-    {
-        feed(*it);
-    }
-}
-
-//--------------------------------------------------------------------------
-//! reset the parser state
-void midi1_byte_stream_parser::reset()
-{
-    m_packet = universal_packet{};
-    m_sysex.clear();
-
-    m_packet_byte       = 1;
-    m_num_missing_bytes = 0;
-}
-
-//--------------------------------------------------------------------------
-
-void midi1_byte_stream_parser::system_realtime(uint8_t byte)
-{
-    if ((byte == 0xF9) || (byte == 0xFD))
-        // undefined
-        return;
-
-    // post packet
-    if (m_invoke_callbacks)
-    {
-        m_packet_callback(make_system_message(m_group, byte));
-    }
-}
+template class basic_midi1_byte_stream_parser<std::function<void(universal_packet)>,
+                                              std::function<void(const midi::sysex7&)>>;
 
 //--------------------------------------------------------------------------
 
-void midi1_byte_stream_parser::system_common(uint8_t byte)
+size_t to_midi1_byte_stream(const universal_packet& p, uint8_t result[8])
 {
-    m_packet            = make_system_message(m_group, byte);
-    m_packet_byte       = 2;
-    m_num_missing_bytes = 0;
+    const auto payload_bytes = midi1_byte_stream_size(p);
 
-    switch (m_packet.status())
-    {
-    case system_status::mtc_quarter_frame:
-    case system_status::song_select:
-        m_num_missing_bytes = 1;
-        break;
-    case system_status::song_position:
-        m_num_missing_bytes = 2;
-        break;
-    case system_status::tune_request:
-        break;
-    default:
-        // undefined, skip, cancel running status
-        m_packet = universal_packet{};
-        return;
-    }
+    size_t result_bytes = 0;
 
-    if (m_num_missing_bytes == 0)
+    switch (p.type())
     {
-        // post packet
-        if (m_invoke_callbacks)
+    case packet_type::system:
+    case packet_type::midi1_channel_voice:
+        if (payload_bytes > 0)
         {
-            m_packet_callback(m_packet);
+            for (; result_bytes < payload_bytes; ++result_bytes)
+                result[result_bytes] = p.get_byte(1 + result_bytes);
         }
+        break;
+    case packet_type::data:
+        if (is_sysex7_packet(p))
+        {
+            const auto status = p.status() & 0xF0;
 
-        // reset
-        m_packet = universal_packet{};
-    }
-}
-
-//--------------------------------------------------------------------------
+            if ((status == data_status::sysex7_complete) || (status == data_status::sysex7_start))
+                result[result_bytes++] = 0xF0;
 
-void midi1_byte_stream_parser::channel_voice(uint8_t byte)
-{
-    m_packet            = midi1_channel_voice_message{ m_group, byte };
-    m_packet_byte       = 2;
-    m_num_missing_bytes = 0;
+            for (size_t b = 0; b < payload_bytes; ++b)
+                result[result_bytes++] = p.get_byte(2 + b);
 
-    switch (m_packet.status() & 0xF0)
-    {
-    case midi1_channel_voice_status::note_off:
-    case midi1_channel_voice_status::note_on:
-    case midi1_channel_voice_status::poly_pressure:
-    case midi1_channel_voice_status::control_change:
-    case midi1_channel_voice_status::pitch_bend:
-        m_num_missing_bytes = 2;
-        break;
-    case midi1_channel_voice_status::program_change:
-    case midi1_channel_voice_status::channel_pressure:
-        m_num_missing_bytes = 1;
+            if ((status == data_status::sysex7_complete) || (status == data_status::sysex7_end))
+                result[result_bytes++] = 0xF7;
+        }
         break;
     default:
-        break;
+        return 0;
     }
 
-    if (m_num_missing_bytes == 0)
-    {
-        // post packet
-        if (m_invoke_callbacks)
-        {
-            m_packet_callback(m_packet);
-        }
-    }
+    return result_bytes;
 }
 
 //--------------------------------------------------------------------------
 
-void midi1_byte_stream_parser::sysex_start()
+midi1_byte_stream_serializer::midi1_byte_stream_serializer(bool running_status)
+  : m_use_running_status(running_status)
 {
-    m_packet            = make_sysex7_start_packet(m_group);
-    m_packet_byte       = 2;
-    m_num_missing_bytes = 0;
-
-    if (has_sysex_callback())
-    {
-        m_sysex.clear();
-        if (m_sysex.data.capacity() < 1024)
-            m_sysex.data.reserve(1024);
-
-        if (!m_invoke_callbacks)
-            m_packet_byte = 0; // do not collect any data
-    }
 }
 
 //--------------------------------------------------------------------------
 
-void midi1_byte_stream_parser::sysex_continue_callback(uint8_t byte)
+void midi1_byte_stream_serializer::enable_running_status(bool enable)
 {
-    switch (m_packet_byte)
-    {
-    case 0:
-    case 1:
-        // skip SysEx data
-        return;
-    case 2: // Manufacturer
-        m_sysex.manufacturerID = (byte << 16);
-        ++m_packet_byte;
-        return;
-    case 3:
-    case 4:
-        if ((m_sysex.manufacturerID & 0xFF0000) == 0) // three byte manufacturer ?
-        {
-            m_sysex.manufacturerID += (byte << ((4 - m_packet_byte) * 8));
-            ++m_packet_byte;
-            return;
-        }
-        break;
-    default:
-        break;
-    }
-
-    // resize necessary?
-    if (m_sysex.data.size() == m_sysex.data.capacity())
-    {
-        m_sysex.data.reserve(m_sysex.data.capacity() * 2);
-    }
-
-    // collect the data
-    m_sysex.data.push_back(byte);
+    m_use_running_status = enable;
+    m_running_status     = 0;
 }
 
 //--------------------------------------------------------------------------
 
-void midi1_byte_stream_parser::sysex_end_callback()
+size_t midi1_byte_stream_serializer::serialize(const universal_packet& p, uint8_t bytes[max_bytes_per_packet])
 {
-    m_packet = universal_packet{};
-
-    if (((m_sysex.manufacturerID & 0xFF0000) == 0) && (m_packet_byte < 5))
-    {
-        // incomplete three byte manufacturer, invalid
-        return;
-    }
-
-    // notify SysEx
-    if (m_invoke_callbacks)
+    if (p.type() == packet_type::midi1_channel_voice)
     {
-        m_sysex_callback(m_sysex);
-    }
-    m_sysex.clear();
-}
+        const auto num_bytes = midi1_byte_stream_size(p);
+        if (num_bytes == 0)
+            return 0;
 
-//--------------------------------------------------------------------------
-
-void midi1_byte_stream_parser::sysex_continue_packet(uint8_t byte)
-{
-    // SysEx as packets
-    m_packet.set_byte(m_packet_byte, byte);
-    if (++m_packet_byte == 8)
-    {
-        if (m_invoke_callbacks)
+        auto status = p.status();
+        auto d2     = p.get_byte(3);
+        if (m_note_off_as_note_on && ((status & 0xF0) == midi1_channel_voice_status::note_off))
         {
-            m_packet.set_byte(1, (m_packet.status() & 0xF0) + 6);
-            m_packet_callback(m_packet);
+            status = midi1_channel_voice_status::note_on | (status & 0x0F);
+            d2     = 0;
         }
 
-        m_packet      = make_sysex7_continue_packet(m_group);
-        m_packet_byte = 2;
-    }
-}
-
-//--------------------------------------------------------------------------
-
-void midi1_byte_stream_parser::sysex_end_packet()
-{
-    const auto cur_sysex_status = uint8_t(m_packet.status() & 0xF0);
-    const auto cur_packet_size  = uint8_t((m_packet_byte - 2) & 0x0F);
-
-    if (cur_sysex_status == data_status::sysex7_start)
-    {
-        if (m_packet_byte < 3)
+        size_t result = 0;
+        if (!m_use_running_status || (status != m_running_status))
         {
-            // no manufacturer, useless
-            m_packet = universal_packet{};
-            return;
+            bytes[result++]  = status;
+            m_running_status = m_use_running_status ? status : 0;
         }
+        bytes[result++] = p.get_byte(2);
+        if (num_bytes == 3)
+            bytes[result++] = d2;
 
-        m_packet.set_byte(1, data_status::sysex7_complete + cur_packet_size);
-    }
-    else
-    {
-        m_packet.set_byte(1, data_status::sysex7_end + cur_packet_size);
+        return result;
     }
 
-    if (m_invoke_callbacks)
-    {
-        m_packet_callback(m_packet);
-    }
+    const auto result = to_midi1_byte_stream(p, bytes);
+
+    // everything but realtime messages cancels running status
+    if ((result > 0) && (bytes[0] < system_status::clock))
+        m_running_status = 0;
 
-    m_packet      = universal_packet{};
-    m_packet_byte = 2;
+    return result;
 }
 
 //--------------------------------------------------------------------------
 
-size_t to_midi1_byte_stream(const universal_packet& p, uint8_t result[8])
+size_t midi1_byte_stream_serializer::serialize(const universal_packet* packets, size_t num_packets, uint8_t* out)
 {
-    const auto payload_bytes = midi1_byte_stream_size(p);
+    assert(packets || !num_packets);
+    assert(out || !num_packets);
 
-    size_t result_bytes = 0;
+    const auto is_realtime = [](const universal_packet& p) {
+        return (p.type() == packet_type::system) && (p.status() >= system_status::clock);
+    };
 
-    switch (p.type())
-    {
-    case packet_type::system:
-    case packet_type::midi1_channel_voice:
-        if (payload_bytes > 0)
-        {
-            for (; result_bytes < payload_bytes; ++result_bytes)
-                result[result_bytes] = p.get_byte(1 + result_bytes);
-        }
-        break;
-    case packet_type::data:
-        if (is_sysex7_packet(p))
-        {
-            const auto status = p.status() & 0xF0;
-
-            if ((status == data_status::sysex7_complete) || (status == data_status::sysex7_start))
-                result[result_bytes++] = 0xF0;
+    size_t result = 0;
 
-            for (size_t b = 0; b < payload_bytes; ++b)
-                result[result_bytes++] = p.get_byte(2 + b);
+    if (m_realtime_first)
+    {
+        for (size_t i = 0; i < num_packets; ++i)
+            if (is_realtime(packets[i]))
+                result += to_midi1_byte_stream(packets[i], out + result);
+    }
 
-            if ((status == data_status::sysex7_complete) || (status == data_status::sysex7_end))
-                result[result_bytes++] = 0xF7;
-        }
-        break;
-    default:
-        return 0;
+    for (size_t i = 0; i < num_packets; ++i)
+    {
+        if (!m_realtime_first || !is_realtime(packets[i]))
+            result += serialize(packets[i], out + result);
     }
 
-    return result_bytes;
+    return result;
 }
 
 //--------------------------------------------------------------------------
@@ -0,0 +1,179 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <midi/midi1_output_pacer.h>
+
+#include <midi/data_message.h>
+#include <midi/midi1_byte_stream.h>
+#include <midi/midi1_channel_voice_message.h>
+#include <midi/system_message.h>
+
+#include <algorithm>
+#include <limits>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+
+midi1_output_pacer::midi1_output_pacer(size_t max_queued_packets)
+  : m_capacity(max_queued_packets)
+{
+}
+
+//--------------------------------------------------------------------------
+
+midi1_output_pacer::priority midi1_output_pacer::packet_priority(const universal_packet& p)
+{
+    switch (p.type())
+    {
+    case packet_type::system:
+        return (p.status() >= system_status::clock) ? priority::realtime : priority::sysex;
+    case packet_type::midi1_channel_voice:
+        switch (p.status() & 0xF0)
+        {
+        case midi1_channel_voice_status::note_off:
+        case midi1_channel_voice_status::note_on:
+            return priority::note;
+        default:
+            return priority::controller;
+        }
+    default:
+        return priority::sysex;
+    }
+}
+
+//--------------------------------------------------------------------------
+//! number of bytes a packet occupies on the wire, not taking running status into account
+size_t midi1_output_pacer::wire_size(const universal_packet& p)
+{
+    auto result = midi1_byte_stream_size(p);
+
+    if (p.type() == packet_type::data)
+    {
+        const auto format = p.status() & 0xF0;
+        if ((format == data_status::sysex7_complete) || (format == data_status::sysex7_start))
+            ++result; // 0xF0
+        if ((format == data_status::sysex7_complete) || (format == data_status::sysex7_end))
+            ++result; // 0xF7
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+bool midi1_output_pacer::push(const universal_packet& p, uint64_t timestamp_us)
+{
+    const auto prio = packet_priority(p);
+
+    if (m_controller_thinning && (prio == priority::controller) && thin(p, timestamp_us))
+        return true;
+
+    if (size() >= m_capacity)
+        return false;
+
+    m_queues[size_t(prio)].push_back(entry{ timestamp_us, p });
+    return true;
+}
+
+//--------------------------------------------------------------------------
+
+bool midi1_output_pacer::thin(const universal_packet& p, uint64_t timestamp_us)
+{
+    // program changes are not controller updates
+    const auto status = p.status() & 0xF0;
+    if (status == midi1_channel_voice_status::program_change)
+        return false;
+
+    // controller index for control change and poly pressure
+    const auto has_index = (status == midi1_channel_voice_status::control_change) ||
+                           (status == midi1_channel_voice_status::poly_pressure);
+    const auto key_mask  = has_index ? 0xFFFFFF00u : 0xFFFF0000u;
+    const auto key       = p.data[0] & key_mask;
+    auto&      queue     = m_queues[size_t(priority::controller)];
+
+    for (auto it = queue.rbegin(); it != queue.rend(); ++it)
+    {
+        if ((it->packet.data[0] & key_mask) == key)
+        {
+            // only replace a value that is held back, i.e. overdue or behind a busy wire
+            if ((it->timestamp > m_now) && (it->timestamp >= m_wire_free))
+                return false;
+
+            // keeps its place, so it must not become due later than the entries behind it
+            it->packet    = p;
+            it->timestamp = std::min(it->timestamp, timestamp_us);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------
+
+std::deque<midi1_output_pacer::entry>* midi1_output_pacer::next_due(uint64_t now_us)
+{
+    for (auto& queue : m_queues)
+        if (!queue.empty() && (queue.front().timestamp <= now_us))
+            return &queue;
+
+    return nullptr;
+}
+
+//--------------------------------------------------------------------------
+
+uint64_t midi1_output_pacer::next_send_time() const
+{
+    auto result = std::numeric_limits<uint64_t>::max();
+    for (const auto& queue : m_queues)
+        if (!queue.empty())
+            result = std::min(result, queue.front().timestamp);
+
+    return (result == std::numeric_limits<uint64_t>::max()) ? result : std::max(result, m_wire_free);
+}
+
+//--------------------------------------------------------------------------
+
+size_t midi1_output_pacer::size() const
+{
+    size_t result = 0;
+    for (const auto& queue : m_queues)
+        result += queue.size();
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+void midi1_output_pacer::clear()
+{
+    for (auto& queue : m_queues)
+        queue.clear();
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
@@ -0,0 +1,140 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <midi/packet_filter.h>
+
+//--------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+
+packet_filter& packet_filter::accept(packet_type type, uint16_t groups, uint16_t statuses, uint16_t channels)
+{
+    const auto base = (uint32_t(type) & 0x0F) << 8;
+    for (auto g = 0u; g < 16; ++g)
+    {
+        if (groups & (1u << g))
+        {
+            for (auto s = 0u; s < 16; ++s)
+            {
+                if (statuses & (1u << s))
+                    m_masks[base | (g << 4) | s] |= channels;
+            }
+        }
+    }
+    return *this;
+}
+
+//--------------------------------------------------------------------------
+
+packet_filter& packet_filter::reject(packet_type type, uint16_t groups, uint16_t statuses, uint16_t channels)
+{
+    const auto base = (uint32_t(type) & 0x0F) << 8;
+    for (auto g = 0u; g < 16; ++g)
+    {
+        if (groups & (1u << g))
+        {
+            for (auto s = 0u; s < 16; ++s)
+            {
+                if (statuses & (1u << s))
+                    m_masks[base | (g << 4) | s] &= uint16_t(~channels);
+            }
+        }
+    }
+    return *this;
+}
+
+//--------------------------------------------------------------------------
+
+packet_filter& packet_filter::accept_all()
+{
+    std::fill(std::begin(m_masks), std::end(m_masks), all);
+    return *this;
+}
+
+//--------------------------------------------------------------------------
+
+packet_filter& packet_filter::reject_all()
+{
+    std::fill(std::begin(m_masks), std::end(m_masks), uint16_t{ 0 });
+    return *this;
+}
+
+//--------------------------------------------------------------------------
+//! copy accepted packets to out, returns the number of accepted packets
+/*! `out` must provide room for `num_packets` packets, filtering in place is supported. */
+size_t packet_filter::apply(const universal_packet* packets, size_t num_packets, universal_packet* out) const
+{
+    assert(packets || !num_packets);
+    assert(out || !num_packets);
+
+    size_t result = 0;
+    for (size_t i = 0; i < num_packets; ++i)
+    {
+        // unconditional copy, only accepted packets advance the output position
+        const bool accepted = accepts(packets[i]);
+        out[result]         = packets[i];
+        result += accepted;
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------
+//! copy accepted packets of a UMP word buffer to out, returns the number of words written
+/*! `out` must provide room for `num_words` words, filtering in place is supported.
+    A trailing incomplete packet is dropped. */
+size_t packet_filter::apply(const uint32_t* words, size_t num_words, uint32_t* out) const
+{
+    assert(words || !num_words);
+    assert(out || !num_words);
+
+    size_t result = 0;
+    size_t pos    = 0;
+    while (pos < num_words)
+    {
+        const auto w   = words[pos];
+        const auto len = packet_size(packet_type(w >> 28u));
+        if (pos + len > num_words)
+            break;
+
+        // unconditional copy, only accepted packets advance the output position
+        for (auto i = 0u; i < len; ++i)
+            out[result + i] = words[pos + i];
+
+        result += len * accepts(w);
+        pos += len;
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
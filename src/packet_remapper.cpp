@@ -0,0 +1,202 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <midi/packet_remapper.h>
+
+//--------------------------------------------------------------------------
+
+#include <cassert>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+
+namespace {
+
+    enum class remap_mode
+    {
+        none,
+        group,
+        group_and_channel
+    };
+
+    constexpr remap_mode remap_mode_of(packet_type type)
+    {
+        switch (type)
+        {
+        case packet_type::system:
+        case packet_type::data:
+        case packet_type::extended_data:
+            return remap_mode::group;
+        case packet_type::midi1_channel_voice:
+        case packet_type::midi2_channel_voice:
+        case packet_type::flex_data:
+            return remap_mode::group_and_channel;
+        default:
+            return remap_mode::none;
+        }
+    }
+
+} // namespace
+
+//--------------------------------------------------------------------------
+
+packet_remapper::packet_remapper()
+{
+    reset();
+}
+
+//--------------------------------------------------------------------------
+
+void packet_remapper::reset()
+{
+    for (auto g = 0u; g < 16; ++g)
+    {
+        m_group_map[g] = uint8_t(g);
+        for (auto c = 0u; c < 16; ++c)
+            m_channel_map[(g << 4) | c] = uint8_t((g << 4) | c);
+    }
+
+    for (auto g = 0u; g < 16; ++g)
+        update(group_t(g));
+}
+
+//--------------------------------------------------------------------------
+//! map a group, including all its channels
+void packet_remapper::map_group(group_t from, group_t to)
+{
+    assert(from < 16);
+    assert(to < 16);
+
+    m_group_map[from] = to;
+    for (auto c = 0u; c < 16; ++c)
+        m_channel_map[(from << 4) | c] = uint8_t((to << 4) | (m_channel_map[(from << 4) | c] & 0x0F));
+
+    update(from);
+}
+
+//--------------------------------------------------------------------------
+//! map a single channel of a group, only affects packets with channel
+void packet_remapper::map_channel(group_t from_group, channel_t from_channel, group_t to_group, channel_t to_channel)
+{
+    assert(from_group < 16);
+    assert(from_channel < 16);
+    assert(to_group < 16);
+    assert(to_channel < 16);
+
+    m_channel_map[(from_group << 4) | from_channel] = uint8_t((to_group << 4) | to_channel);
+
+    update(from_group);
+}
+
+//--------------------------------------------------------------------------
+
+group_t packet_remapper::group_for(group_t g) const
+{
+    assert(g < 16);
+    return m_group_map[g];
+}
+
+//--------------------------------------------------------------------------
+
+group_t packet_remapper::group_for(group_t g, channel_t c) const
+{
+    assert(g < 16);
+    assert(c < 16);
+    return m_channel_map[(g << 4) | c] >> 4;
+}
+
+//--------------------------------------------------------------------------
+
+channel_t packet_remapper::channel_for(group_t g, channel_t c) const
+{
+    assert(g < 16);
+    assert(c < 16);
+    return m_channel_map[(g << 4) | c] & 0x0F;
+}
+
+//--------------------------------------------------------------------------
+//! recompile the lookup table entries of a group
+void packet_remapper::update(group_t g)
+{
+    for (auto t = 0u; t < 16; ++t)
+    {
+        const auto mode = remap_mode_of(packet_type(t));
+        for (auto c = 0u; c < 16; ++c)
+        {
+            auto& entry = m_table[(t << 8) | (g << 4) | c];
+            switch (mode)
+            {
+            case remap_mode::group:
+                entry = uint8_t((m_group_map[g] << 4) | c);
+                break;
+            case remap_mode::group_and_channel:
+                entry = m_channel_map[(g << 4) | c];
+                break;
+            default:
+                entry = uint8_t((g << 4) | c);
+                break;
+            }
+        }
+    }
+
+    // group addressed flex data, the channel nibble is not a channel
+    for (auto c = 0u; c < 16; ++c)
+        m_table[0x1000 | (g << 4) | c] = uint8_t((m_group_map[g] << 4) | c);
+}
+
+//--------------------------------------------------------------------------
+
+void packet_remapper::apply(universal_packet* packets, size_t num_packets) const
+{
+    assert(packets || !num_packets);
+
+    for (size_t i = 0; i < num_packets; ++i)
+        packets[i].data[0] = remap(packets[i].data[0]);
+}
+
+//--------------------------------------------------------------------------
+//! remap all complete packets of a UMP word buffer, returns the number of words processed
+size_t packet_remapper::apply(uint32_t* words, size_t num_words) const
+{
+    assert(words || !num_words);
+
+    size_t pos = 0;
+    while (pos < num_words)
+    {
+        const auto len = packet_size(packet_type(words[pos] >> 28u));
+        if (pos + len > num_words)
+            break;
+
+        words[pos] = remap(words[pos]);
+        pos += len;
+    }
+    return pos;
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
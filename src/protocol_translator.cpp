@@ -0,0 +1,557 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <midi/protocol_translator.h>
+
+#include <midi/channel_voice_message.h>
+#include <midi/midi1_channel_voice_message.h>
+#include <midi/midi2_channel_voice_message.h>
+
+#include <algorithm>
+#include <cassert>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+
+namespace {
+
+    constexpr uint16_t no_selected_parameter = 0xFFFF;
+
+    constexpr uint16_t make_selected_parameter(bool registered, uint7_t msb, uint7_t lsb)
+    {
+        return uint16_t((registered ? 0x4000u : 0x0000u) | (msb << 7) | lsb);
+    }
+
+    constexpr size_t conversion_block_size = 64;
+
+    constexpr bool is_reserved_controller(controller_t controller)
+    {
+        switch (controller)
+        {
+        case control_change::bank_select_msb:
+        case control_change::data_entry_msb:
+        case control_change::bank_select_lsb:
+        case control_change::data_entry_lsb:
+        case control_change::hi_res_velocity_prefix:
+        case control_change::nrpn_lsb:
+        case control_change::nrpn_msb:
+        case control_change::rpn_lsb:
+        case control_change::rpn_msb:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // value7 / value14 are the upscaled 7 bit and 14 bit values of the message
+    bool convert_midi1_message(const universal_packet& p, uint32_t value7, uint32_t value14, universal_packet& out)
+    {
+        const midi1_channel_voice_message_view m{ p };
+
+        const auto group   = m.group();
+        const auto channel = m.channel();
+
+        switch (m.status())
+        {
+        case channel_voice_status::note_off:
+            out = make_midi2_note_off_message(group, channel, m.data_byte_1(), velocity{ uint16_t(value7 >> 16) });
+            return true;
+        case channel_voice_status::note_on:
+            if (m.data_byte_2() == 0)
+                out = make_midi2_note_off_message(group, channel, m.data_byte_1(), velocity{ uint16_t(0x8000) });
+            else
+                out = make_midi2_note_on_message(group, channel, m.data_byte_1(), velocity{ uint16_t(value7 >> 16) });
+            return true;
+        case channel_voice_status::poly_pressure:
+            out = make_midi2_poly_pressure_message(group, channel, m.data_byte_1(), controller_value{ value7 });
+            return true;
+        case channel_voice_status::control_change:
+            if (is_reserved_controller(m.data_byte_1()))
+                return false;
+            out = make_midi2_control_change_message(group, channel, m.data_byte_1(), controller_value{ value7 });
+            return true;
+        case channel_voice_status::program_change:
+            out = make_midi2_program_change_message(group, channel, m.data_byte_1());
+            return true;
+        case channel_voice_status::channel_pressure:
+            out = make_midi2_channel_pressure_message(group, channel, controller_value{ value7 });
+            return true;
+        case channel_voice_status::pitch_bend:
+            out = make_midi2_pitch_bend_message(group, channel, pitch_bend{ value14 });
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // value7 is the downscaled 7 bit value of the message
+    bool convert_midi2_message(const universal_packet& p, uint7_t value7, universal_packet& out)
+    {
+        const midi2_channel_voice_message_view m{ p };
+
+        const auto word0 = p.data[0];
+        const auto base  = 0x20000000u | (word0 & 0x0FFF0000u); // MIDI 1 packet with group and status
+
+        switch (p.status() & 0xF0)
+        {
+        case channel_voice_status::note_off:
+            if (m.byte4() != 0) // no attributes in MIDI 1
+                return false;
+            out = universal_packet{ base | (word0 & 0x7F00u) | value7 };
+            return true;
+        case channel_voice_status::note_on:
+            if (m.byte4() != 0) // no attributes in MIDI 1
+                return false;
+            out = universal_packet{ base | (word0 & 0x7F00u) | std::max(value7, uint7_t{ 1 }) };
+            return true;
+        case channel_voice_status::poly_pressure:
+            out = universal_packet{ base | (word0 & 0x7F00u) | value7 };
+            return true;
+        case channel_voice_status::control_change:
+            if (is_reserved_controller(m.byte3()))
+                return false;
+            out = universal_packet{ base | (word0 & 0x7F00u) | value7 };
+            return true;
+        case channel_voice_status::program_change:
+            if (m.byte4() & 0b1) // bank valid
+                return false;
+            out = universal_packet{ base | ((p.data[1] >> 16) & 0x7F00u) };
+            return true;
+        case channel_voice_status::channel_pressure:
+            out = universal_packet{ base | (uint32_t(value7) << 8) };
+            return true;
+        case channel_voice_status::pitch_bend: {
+            const auto value14 = downsample_32_to_14bit(p.data[1]);
+            out                = universal_packet{ base | ((value14 & 0x7Fu) << 8) | (value14 >> 7) };
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+} // namespace
+
+//--------------------------------------------------------------------------
+
+midi2_to_midi1_translator::midi2_to_midi1_translator()
+{
+    reset();
+}
+
+//--------------------------------------------------------------------------
+
+void midi2_to_midi1_translator::reset()
+{
+    for (auto& parameter : m_parameter)
+        parameter = no_selected_parameter;
+}
+
+//--------------------------------------------------------------------------
+
+size_t midi2_to_midi1_translator::translate(const universal_packet& p, universal_packet out[max_packets_per_packet])
+{
+    if (p.type() != packet_type::midi2_channel_voice)
+    {
+        // parameter numbers selected by MIDI 1 messages are unknown
+        if (is_control_change_message(p) && (get_controller_nr(p) >= control_change::nrpn_lsb))
+            m_parameter[(p.group() << 4) | (p.status() & 0x0F)] = no_selected_parameter;
+
+        out[0] = p;
+        return 1;
+    }
+
+    const midi2_channel_voice_message_view m{ p };
+
+    const auto group   = m.group();
+    const auto channel = m.channel();
+
+    const auto cc = [group, channel](controller_t controller, uint7_t value) {
+        return make_midi1_control_change_message(group, channel, controller, controller_value{ value });
+    };
+
+    switch (m.status())
+    {
+    case channel_voice_status::note_off:
+        out[0] = make_midi1_note_off_message(group, channel, m.byte3(), velocity{ uint16_t(m.data() >> 16) });
+        return 1;
+    case channel_voice_status::note_on: {
+        auto vel = velocity{ uint16_t(m.data() >> 16) };
+        if (vel.as_uint7() == 0)
+            vel = velocity{ uint7_t{ 1 } };
+
+        out[0] = make_midi1_note_on_message(group, channel, m.byte3(), vel);
+        return 1;
+    }
+    case channel_voice_status::program_change: {
+        size_t result = 0;
+        if (m.byte4() & 0b1) // bank valid
+        {
+            out[result++] = cc(control_change::bank_select_msb, uint7_t((m.data() >> 8) & 0x7F));
+            out[result++] = cc(control_change::bank_select_lsb, uint7_t(m.data() & 0x7F));
+        }
+        out[result++] = make_midi1_program_change_message(group, channel, uint7_t((m.data() >> 24) & 0x7F));
+        return result;
+    }
+    case channel_voice_status::registered_controller:
+    case channel_voice_status::assignable_controller: {
+        const bool registered = (m.status() == channel_voice_status::registered_controller);
+        const auto parameter  = make_selected_parameter(registered, m.byte3(), m.byte4());
+        auto&      selected   = m_parameter[(group << 4) | channel];
+
+        size_t result = 0;
+        if (selected != parameter)
+        {
+            out[result++] = cc(registered ? control_change::rpn_msb : control_change::nrpn_msb, m.byte3());
+            out[result++] = cc(registered ? control_change::rpn_lsb : control_change::nrpn_lsb, m.byte4());
+            selected      = parameter;
+        }
+
+        const auto value = downsample_32_to_14bit(m.data());
+        out[result++]    = cc(control_change::data_entry_msb, uint7_t(value >> 7));
+        out[result++]    = cc(control_change::data_entry_lsb, uint7_t(value & 0x7F));
+        return result;
+    }
+    default:
+        if (const auto m1 = as_midi1_channel_voice_message(m))
+        {
+            out[0] = *m1;
+            return 1;
+        }
+        break;
+    }
+
+    return 0;
+}
+
+//--------------------------------------------------------------------------
+
+size_t midi2_to_midi1_translator::translate(const universal_packet* packets,
+                                            size_t                  num_packets,
+                                            universal_packet*       out,
+                                            uint8_t*                num_out)
+{
+    assert(packets || !num_packets);
+    assert(out || !num_packets);
+
+    size_t result = 0;
+    for (size_t i = 0; i < num_packets; ++i)
+    {
+        const auto n = translate(packets[i], out + result);
+        if (num_out)
+            num_out[i] = uint8_t(n);
+        result += n;
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+midi1_to_midi2_translator::midi1_to_midi2_translator()
+{
+    reset();
+}
+
+//--------------------------------------------------------------------------
+
+void midi1_to_midi2_translator::reset()
+{
+    for (size_t i = 0; i < 256; ++i)
+    {
+        m_bank_msb[i]       = 0x80;
+        m_bank_lsb[i]       = 0x80;
+        m_parameter_type[i] = 0;
+        m_parameter_msb[i]  = 0x80;
+        m_parameter_lsb[i]  = 0x80;
+        m_data_entry_msb[i] = 0x80;
+
+        for (auto& msb : m_controller_msb[i])
+            msb = 0x80;
+    }
+}
+
+//--------------------------------------------------------------------------
+
+size_t midi1_to_midi2_translator::translate(const universal_packet& p, universal_packet out[max_packets_per_packet])
+{
+    if (p.type() != packet_type::midi1_channel_voice)
+    {
+        out[0] = p;
+        return 1;
+    }
+
+    const midi1_channel_voice_message_view m{ p };
+
+    switch (m.status())
+    {
+    case channel_voice_status::control_change:
+        return translate_control_change(p, out[0]);
+    case channel_voice_status::program_change: {
+        const auto index = (m.group() << 4) | m.channel();
+        if (m_bank_msb[index] & m_bank_lsb[index] & 0x80) // no bank select received
+        {
+            out[0] = make_midi2_program_change_message(m.group(), m.channel(), m.data_byte_1());
+        }
+        else
+        {
+            const auto bank = uint14_t(((m_bank_msb[index] & 0x7F) << 7) | (m_bank_lsb[index] & 0x7F));
+            out[0]          = make_midi2_program_change_message(m.group(), m.channel(), m.data_byte_1(), bank);
+        }
+        return 1;
+    }
+    default:
+        if (const auto m2 = as_midi2_channel_voice_message(m))
+        {
+            out[0] = *m2;
+            return 1;
+        }
+        break;
+    }
+
+    return 0;
+}
+
+//--------------------------------------------------------------------------
+
+size_t midi1_to_midi2_translator::translate_control_change(const universal_packet& p, universal_packet& out)
+{
+    const midi1_channel_voice_message_view m{ p };
+
+    const auto group      = m.group();
+    const auto channel    = m.channel();
+    const auto index      = (group << 4) | channel;
+    const auto controller = m.data_byte_1();
+    const auto value      = m.data_byte_2();
+
+    const auto select_parameter = [this, index](controller_t type, uint8_t& part, uint7_t v) {
+        if (m_parameter_type[index] != type)
+        {
+            m_parameter_type[index] = type;
+            m_parameter_msb[index]  = 0x80;
+            m_parameter_lsb[index]  = 0x80;
+        }
+        part                    = v;
+        m_data_entry_msb[index] = 0x80;
+    };
+
+    switch (controller)
+    {
+    case control_change::bank_select_msb:
+        m_bank_msb[index] = value;
+        return 0;
+    case control_change::bank_select_lsb:
+        m_bank_lsb[index] = value;
+        return 0;
+    case control_change::rpn_msb:
+        select_parameter(control_change::rpn_lsb, m_parameter_msb[index], value);
+        return 0;
+    case control_change::rpn_lsb:
+        select_parameter(control_change::rpn_lsb, m_parameter_lsb[index], value);
+        return 0;
+    case control_change::nrpn_msb:
+        select_parameter(control_change::nrpn_lsb, m_parameter_msb[index], value);
+        return 0;
+    case control_change::nrpn_lsb:
+        select_parameter(control_change::nrpn_lsb, m_parameter_lsb[index], value);
+        return 0;
+    case control_change::data_entry_msb:
+    case control_change::data_entry_lsb: {
+        const auto type = m_parameter_type[index];
+        const auto msb  = m_parameter_msb[index];
+        const auto lsb  = m_parameter_lsb[index];
+
+        if (!type || ((msb | lsb) & 0x80))
+            return 0; // no parameter selected
+
+        if ((type == control_change::rpn_lsb) && (msb == 0x7F) && (lsb == 0x7F))
+            return 0; // RPN null
+
+        controller_value v;
+        if (controller == control_change::data_entry_msb)
+        {
+            m_data_entry_msb[index] = value;
+            v                       = controller_value{ upsample_7_to_32bit(value) };
+        }
+        else if (m_data_entry_msb[index] & 0x80)
+        {
+            return 0; // LSB without MSB
+        }
+        else
+        {
+            v = controller_value{ upsample_14_to_32bit(uint14_t((m_data_entry_msb[index] << 7) | value)) };
+        }
+
+        out = (type == control_change::rpn_lsb) ? make_registered_controller_message(group, channel, msb, lsb, v)
+                                                : make_assignable_controller_message(group, channel, msb, lsb, v);
+        return 1;
+    }
+    default:
+        break;
+    }
+
+    if (controller < control_change::lsb)
+    {
+        m_controller_msb[index][controller] = value;
+    }
+    else if (controller < 2 * control_change::lsb)
+    {
+        // LSB of controllers 1..31
+        const auto msb_controller = uint7_t(controller - control_change::lsb);
+        const auto msb            = m_controller_msb[index][msb_controller];
+        if (!(msb & 0x80))
+        {
+            const auto v = controller_value{ upsample_14_to_32bit(uint14_t((msb << 7) | value)) };
+            out          = make_midi2_control_change_message(group, channel, msb_controller, v);
+            return 1;
+        }
+    }
+
+    if (const auto m2 = as_midi2_channel_voice_message(m))
+    {
+        out = *m2;
+        return 1;
+    }
+
+    return 0;
+}
+
+//--------------------------------------------------------------------------
+
+size_t midi1_to_midi2_translator::translate(const universal_packet* packets,
+                                            size_t                  num_packets,
+                                            universal_packet*       out,
+                                            uint8_t*                num_out)
+{
+    assert(packets || !num_packets);
+    assert(out || !num_packets);
+
+    size_t result = 0;
+    for (size_t i = 0; i < num_packets; ++i)
+    {
+        const auto n = translate(packets[i], out + result);
+        if (num_out)
+            num_out[i] = uint8_t(n);
+        result += n;
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+size_t convert_midi1_to_midi2(const universal_packet* packets,
+                              size_t                  num_packets,
+                              universal_packet*       out,
+                              uint8_t*                num_out)
+{
+    assert(packets || !num_packets);
+    assert(out || !num_packets);
+
+    uint7_t  values7[conversion_block_size];
+    uint14_t values14[conversion_block_size];
+    uint32_t upsampled7[conversion_block_size];
+    uint32_t upsampled14[conversion_block_size];
+
+    size_t result = 0;
+    for (size_t block = 0; block < num_packets; block += conversion_block_size)
+    {
+        const auto* in = packets + block;
+        const auto  n  = std::min(conversion_block_size, num_packets - block);
+
+        // gather the values of the whole block, channel pressure has its value in data byte 1
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto word0 = in[i].data[0];
+            const auto data1 = uint7_t((word0 >> 8) & 0x7F);
+            const auto data2 = uint7_t(word0 & 0x7F);
+            values7[i]       = ((word0 & 0x00F00000) == 0x00D00000) ? data1 : data2;
+            values14[i]      = uint14_t(data1 | (data2 << 7));
+        }
+
+        upsample_7_to_32bit(values7, n, upsampled7);
+        upsample_14_to_32bit(values14, n, upsampled14);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            bool written = true;
+            if (in[i].type() == packet_type::midi1_channel_voice)
+                written = convert_midi1_message(in[i], upsampled7[i], upsampled14[i], out[result]);
+            else
+                out[result] = in[i];
+
+            if (num_out)
+                num_out[block + i] = uint8_t(written);
+            result += written;
+        }
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+size_t convert_midi2_to_midi1(const universal_packet* packets,
+                              size_t                  num_packets,
+                              universal_packet*       out,
+                              uint8_t*                num_out)
+{
+    assert(packets || !num_packets);
+    assert(out || !num_packets);
+
+    uint32_t values[conversion_block_size];
+    uint7_t  downsampled[conversion_block_size];
+
+    size_t result = 0;
+    for (size_t block = 0; block < num_packets; block += conversion_block_size)
+    {
+        const auto* in = packets + block;
+        const auto  n  = std::min(conversion_block_size, num_packets - block);
+
+        for (size_t i = 0; i < n; ++i)
+            values[i] = in[i].data[1];
+
+        downsample_32_to_7bit(values, n, downsampled);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            bool written = true;
+            if (in[i].type() == packet_type::midi2_channel_voice)
+                written = convert_midi2_message(in[i], downsampled[i], out[result]);
+            else
+                out[result] = in[i];
+
+            if (num_out)
+                num_out[block + i] = uint8_t(written);
+            result += written;
+        }
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
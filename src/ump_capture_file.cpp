@@ -0,0 +1,291 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <midi/ump_capture_file.h>
+
+//--------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+
+namespace {
+
+    constexpr uint8_t  capture_magic[4]       = { 'U', 'M', 'P', 'C' };
+    constexpr uint32_t capture_byte_order_mark = 0x01020304u;
+
+    bool is_valid_capture_header(const uint8_t* header)
+    {
+        uint32_t byte_order_mark = 0;
+        std::memcpy(&byte_order_mark, header + 8, sizeof(byte_order_mark));
+
+        return (std::memcmp(header, capture_magic, sizeof(capture_magic)) == 0) &&
+               (header[4] == ump_capture_format_version) && (byte_order_mark == capture_byte_order_mark);
+    }
+
+} // namespace
+
+//--------------------------------------------------------------------------
+
+size_t write_ump_capture_header(uint8_t* out, size_t out_size)
+{
+    assert(out != nullptr);
+
+    if (out_size < ump_capture_header_size)
+        return 0;
+
+    std::memset(out, 0, ump_capture_header_size);
+    std::memcpy(out, capture_magic, sizeof(capture_magic));
+    out[4] = ump_capture_format_version;
+    std::memcpy(out + 8, &capture_byte_order_mark, sizeof(capture_byte_order_mark));
+
+    return ump_capture_header_size;
+}
+
+//--------------------------------------------------------------------------
+
+bool write_ump_capture_header(std::FILE* file)
+{
+    assert(file != nullptr);
+
+    uint8_t header[ump_capture_header_size];
+    write_ump_capture_header(header, sizeof(header));
+    return std::fwrite(header, 1, sizeof(header), file) == sizeof(header);
+}
+
+//--------------------------------------------------------------------------
+
+ump_capture_file::~ump_capture_file()
+{
+    close();
+}
+
+//--------------------------------------------------------------------------
+
+ump_capture_file::ump_capture_file(ump_capture_file&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+//--------------------------------------------------------------------------
+
+ump_capture_file& ump_capture_file::operator=(ump_capture_file&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+
+        m_data               = std::exchange(other.m_data, nullptr);
+        m_size               = std::exchange(other.m_size, 0);
+        m_num_words          = std::exchange(other.m_num_words, 0);
+        m_num_trailing_bytes = std::exchange(other.m_num_trailing_bytes, 0);
+#ifdef _WIN32
+        m_file    = std::exchange(other.m_file, nullptr);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+        m_time_index = std::move(other.m_time_index);
+        other.m_time_index.clear();
+    }
+    return *this;
+}
+
+//--------------------------------------------------------------------------
+
+bool ump_capture_file::open(const char* path)
+{
+    assert(path != nullptr);
+
+    close();
+
+#ifdef _WIN32
+    m_file = CreateFileA(
+      path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        m_file = nullptr;
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(m_file, &file_size) || (file_size.QuadPart < LONGLONG(ump_capture_header_size)))
+    {
+        close();
+        return false;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping)
+    {
+        close();
+        return false;
+    }
+
+    m_data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!m_data)
+    {
+        close();
+        return false;
+    }
+    m_size = size_t(file_size.QuadPart);
+#else
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if ((::fstat(fd, &st) != 0) || (st.st_size < off_t(ump_capture_header_size)))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* data = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+#ifdef MADV_SEQUENTIAL
+    ::madvise(data, size_t(st.st_size), MADV_SEQUENTIAL);
+#endif
+
+    m_data = data;
+    m_size = size_t(st.st_size);
+#endif
+
+    if (!is_valid_capture_header(static_cast<const uint8_t*>(m_data)))
+    {
+        close();
+        return false;
+    }
+
+    m_num_words          = (m_size - ump_capture_header_size) / 4;
+    m_num_trailing_bytes = (m_size - ump_capture_header_size) % 4;
+    return true;
+}
+
+//--------------------------------------------------------------------------
+
+void ump_capture_file::close()
+{
+#ifdef _WIN32
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+    if (m_file)
+        CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file    = nullptr;
+#else
+    if (m_data)
+        ::munmap(m_data, m_size);
+#endif
+
+    m_data               = nullptr;
+    m_size               = 0;
+    m_num_words          = 0;
+    m_num_trailing_bytes = 0;
+    m_time_index.clear();
+}
+
+//--------------------------------------------------------------------------
+
+const uint32_t* ump_capture_file::words() const
+{
+    return m_data ? reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(m_data) + ump_capture_header_size)
+                  : nullptr;
+}
+
+//--------------------------------------------------------------------------
+//! index JR timestamp messages, adds an entry whenever `interval` ticks have passed since the last entry
+void ump_capture_file::build_time_index(jr_ticks interval)
+{
+    m_time_index.clear();
+
+    const auto view = packets();
+
+    bool           has_timestamp = false;
+    jr_timestamp_t last_timestamp;
+    jr_ticks       ticks{ 0 };
+
+    for (auto it = view.begin(); it != view.end(); ++it)
+    {
+        const auto p = *it;
+        if ((p.type() != packet_type::utility) || (p.status() != utility_status::jr_timestamp))
+            continue;
+
+        const jr_timestamp_t timestamp{ static_cast<uint16_t>((p.byte3() << 8) | p.byte4()) };
+        if (has_timestamp)
+            ticks += timestamp - last_timestamp;
+        last_timestamp = timestamp;
+
+        if (!has_timestamp || (ticks - m_time_index.back().ticks >= interval))
+            m_time_index.push_back(time_index_entry{ ticks, size_t(it.position() - view.data()) });
+
+        has_timestamp = true;
+    }
+}
+
+//--------------------------------------------------------------------------
+//! packets starting at the last indexed JR timestamp not later than `ticks`
+/*! Without a time index or for times before the first index entry all packets are returned. */
+ump_stream_view ump_capture_file::packets_from(jr_ticks ticks) const
+{
+    const auto it = std::upper_bound(m_time_index.begin(),
+                                     m_time_index.end(),
+                                     ticks,
+                                     [](jr_ticks t, const time_index_entry& e) { return t < e.ticks; });
+    if (it == m_time_index.begin())
+        return packets();
+
+    const auto offset = std::prev(it)->word_offset;
+    return ump_stream_view{ words() + offset, m_num_words - offset };
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
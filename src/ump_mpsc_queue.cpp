@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <midi/ump_mpsc_queue.h>
+
+#include <cstdint>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+
+namespace {
+
+    size_t round_up_queue_capacity(size_t capacity)
+    {
+        size_t result = 2;
+        while (result < capacity)
+            result <<= 1;
+        return result;
+    }
+
+} // namespace
+
+//--------------------------------------------------------------------------
+
+ump_mpsc_queue::ump_mpsc_queue(size_t capacity)
+  : m_mask(round_up_queue_capacity(capacity) - 1)
+  , m_cells(new cell[m_mask + 1])
+{
+    for (size_t i = 0; i <= m_mask; ++i)
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------
+//! push an entry, returns false if the queue is full
+bool ump_mpsc_queue::try_push(const entry& e)
+{
+    // every cell carries a sequence number that tells producers and the consumer
+    // whether it is free for the enqueue index (sequence == index) or filled
+    // for the dequeue index (sequence == index + 1)
+    auto  index = m_enqueue_index.load(std::memory_order_relaxed);
+    cell* c     = nullptr;
+    for (;;)
+    {
+        c                   = &m_cells[index & m_mask];
+        const auto sequence = c->sequence.load(std::memory_order_acquire);
+        const auto diff     = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(index);
+        if (diff == 0)
+        {
+            if (m_enqueue_index.compare_exchange_weak(index, index + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            return false; // full
+        }
+        else
+        {
+            index = m_enqueue_index.load(std::memory_order_relaxed);
+        }
+    }
+
+    c->data = e;
+    c->sequence.store(index + 1, std::memory_order_release);
+    return true;
+}
+
+//--------------------------------------------------------------------------
+//! pop the oldest entry, to be called from the consumer thread only
+std::optional<ump_mpsc_queue::entry> ump_mpsc_queue::try_pop()
+{
+    auto& c = m_cells[m_dequeue_index & m_mask];
+    if (c.sequence.load(std::memory_order_acquire) != m_dequeue_index + 1)
+        return std::nullopt; // empty or producer not yet done
+
+    entry result = c.data;
+    c.sequence.store(m_dequeue_index + m_mask + 1, std::memory_order_release);
+    ++m_dequeue_index;
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
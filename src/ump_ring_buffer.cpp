@@ -0,0 +1,231 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <midi/ump_ring_buffer.h>
+
+#include <cassert>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+
+namespace {
+
+    constexpr size_t min_capacity = 8; //!< two maximum sized packets minus one word
+
+    //! a first word with a packet size that never fits into the remaining words at the end of the ring
+    constexpr uint32_t padding_marker = 0xFFFFFFFFu;
+    static_assert(packet_size(packet_type(padding_marker >> 28)) == 4);
+
+    size_t round_up_capacity(size_t capacity)
+    {
+        size_t result = min_capacity;
+        while (result < capacity)
+            result <<= 1;
+        return result;
+    }
+
+    size_t size_of_word(uint32_t word)
+    {
+        return packet_size(packet_type(word >> 28u));
+    }
+
+} // namespace
+
+//--------------------------------------------------------------------------
+
+ump_ring_buffer::ump_ring_buffer(size_t capacity_in_words)
+  : m_mask(round_up_capacity(capacity_in_words) - 1)
+  , m_words(new uint32_t[m_mask + 1]{})
+{
+}
+
+//--------------------------------------------------------------------------
+//! number of free words, refreshes the producer's copy of the read index only if needed
+size_t ump_ring_buffer::free_words(size_t write_index, size_t needed)
+{
+    auto result = capacity() - (write_index - m_cached_read_index);
+    if (result < needed)
+    {
+        m_cached_read_index = m_read_index.load(std::memory_order_acquire);
+        result              = capacity() - (write_index - m_cached_read_index);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------
+//! number of readable words, refreshes the consumer's copy of the write index only if needed
+size_t ump_ring_buffer::available_words(size_t read_index)
+{
+    if (read_index == m_cached_write_index)
+    {
+        m_cached_write_index = m_write_index.load(std::memory_order_acquire);
+    }
+    return m_cached_write_index - read_index;
+}
+
+//--------------------------------------------------------------------------
+//! reserve space for a packet, returns the write index of the packet or write_index + capacity if full
+size_t ump_ring_buffer::reserve_packet(size_t write_index, size_t packet_size)
+{
+    const auto pos        = write_index & m_mask;
+    const auto contiguous = capacity() - pos;
+    const auto padding    = (contiguous < packet_size) ? contiguous : 0u;
+
+    if (free_words(write_index, padding + packet_size) < padding + packet_size)
+        return write_index + capacity();
+
+    if (padding)
+    {
+        m_words[pos] = padding_marker;
+    }
+
+    return write_index + padding;
+}
+
+//--------------------------------------------------------------------------
+//! skip padding at the end of the ring
+size_t ump_ring_buffer::skip_padding(size_t read_index) const
+{
+    const auto pos = read_index & m_mask;
+    if (pos + size_of_word(m_words[pos]) > capacity())
+        return read_index + capacity() - pos;
+    return read_index;
+}
+
+//--------------------------------------------------------------------------
+
+bool ump_ring_buffer::try_push(const universal_packet& p)
+{
+    const auto write_index = m_write_index.load(std::memory_order_relaxed);
+    const auto size        = p.size();
+    const auto index       = reserve_packet(write_index, size);
+    if (index == write_index + capacity())
+        return false;
+
+    const auto pos = index & m_mask;
+    for (auto w = 0u; w < size; ++w)
+        m_words[pos + w] = p.data[w];
+
+    m_write_index.store(index + size, std::memory_order_release);
+    return true;
+}
+
+//--------------------------------------------------------------------------
+//! push complete packets from a word buffer until the ring is full, returns the number of words written
+size_t ump_ring_buffer::write(const uint32_t* words, size_t num_words)
+{
+    assert(words || !num_words);
+
+    const auto first_index = m_write_index.load(std::memory_order_relaxed);
+    auto       index       = first_index;
+    size_t     consumed    = 0;
+
+    while (consumed < num_words)
+    {
+        const auto size = size_of_word(words[consumed]);
+        if (consumed + size > num_words)
+            break; // incomplete packet
+
+        const auto packet_index = reserve_packet(index, size);
+        if (packet_index == index + capacity())
+            break; // full
+
+        const auto pos = packet_index & m_mask;
+        for (auto w = 0u; w < size; ++w)
+            m_words[pos + w] = words[consumed + w];
+
+        index = packet_index + size;
+        consumed += size;
+    }
+
+    if (index != first_index)
+        m_write_index.store(index, std::memory_order_release);
+
+    return consumed;
+}
+
+//--------------------------------------------------------------------------
+
+std::optional<universal_packet> ump_ring_buffer::try_pop()
+{
+    const auto read_index = m_read_index.load(std::memory_order_relaxed);
+    if (available_words(read_index) == 0)
+        return std::nullopt;
+
+    const auto index = skip_padding(read_index);
+    const auto pos   = index & m_mask;
+
+    universal_packet result;
+    const auto       size = size_of_word(m_words[pos]);
+    for (auto w = 0u; w < size; ++w)
+        result.data[w] = m_words[pos + w];
+
+    m_read_index.store(index + size, std::memory_order_release);
+    return result;
+}
+
+//--------------------------------------------------------------------------
+//! pop complete packets into a word buffer, returns the number of words read
+size_t ump_ring_buffer::read(uint32_t* words, size_t max_words)
+{
+    assert(words || !max_words);
+
+    const auto first_index = m_read_index.load(std::memory_order_relaxed);
+    auto       index       = first_index;
+    size_t     num_read    = 0;
+
+    while (available_words(index) > 0)
+    {
+        const auto packet_index = skip_padding(index);
+        const auto pos          = packet_index & m_mask;
+        const auto size         = size_of_word(m_words[pos]);
+        if (num_read + size > max_words)
+            break;
+
+        for (auto w = 0u; w < size; ++w)
+            words[num_read + w] = m_words[pos + w];
+
+        index = packet_index + size;
+        num_read += size;
+    }
+
+    if (index != first_index)
+        m_read_index.store(index, std::memory_order_release);
+
+    return num_read;
+}
+
+//--------------------------------------------------------------------------
+//! check if the queue is empty, to be called from the consumer thread
+bool ump_ring_buffer::empty() const
+{
+    return m_read_index.load(std::memory_order_relaxed) == m_write_index.load(std::memory_order_acquire);
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
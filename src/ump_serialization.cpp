@@ -0,0 +1,333 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <midi/ump_serialization.h>
+
+//--------------------------------------------------------------------------
+
+#include <cassert>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+
+namespace {
+
+    constexpr uint8_t record_magic[4]        = { 'U', 'M', 'P', 'B' };
+    constexpr uint8_t record_flag_big_endian = 0x01;
+    constexpr uint8_t record_flag_timestamps = 0x02;
+    constexpr size_t  record_file_chunk_size = 4096;
+
+    inline void store_u32(uint8_t* out, uint32_t v, byte_order order)
+    {
+        if (order == byte_order::little_endian)
+        {
+            out[0] = uint8_t(v);
+            out[1] = uint8_t(v >> 8);
+            out[2] = uint8_t(v >> 16);
+            out[3] = uint8_t(v >> 24);
+        }
+        else
+        {
+            out[0] = uint8_t(v >> 24);
+            out[1] = uint8_t(v >> 16);
+            out[2] = uint8_t(v >> 8);
+            out[3] = uint8_t(v);
+        }
+    }
+
+    inline uint32_t load_u32(const uint8_t* in, byte_order order)
+    {
+        if (order == byte_order::little_endian)
+            return uint32_t(in[0]) | (uint32_t(in[1]) << 8) | (uint32_t(in[2]) << 16) | (uint32_t(in[3]) << 24);
+        else
+            return (uint32_t(in[0]) << 24) | (uint32_t(in[1]) << 16) | (uint32_t(in[2]) << 8) | uint32_t(in[3]);
+    }
+
+    inline void store_u64(uint8_t* out, uint64_t v, byte_order order)
+    {
+        if (order == byte_order::little_endian)
+        {
+            store_u32(out, uint32_t(v), order);
+            store_u32(out + 4, uint32_t(v >> 32), order);
+        }
+        else
+        {
+            store_u32(out, uint32_t(v >> 32), order);
+            store_u32(out + 4, uint32_t(v), order);
+        }
+    }
+
+    inline uint64_t load_u64(const uint8_t* in, byte_order order)
+    {
+        if (order == byte_order::little_endian)
+            return uint64_t(load_u32(in, order)) | (uint64_t(load_u32(in + 4, order)) << 32);
+        else
+            return (uint64_t(load_u32(in, order)) << 32) | uint64_t(load_u32(in + 4, order));
+    }
+
+    //! parse a record body (everything after the word count), returns the packet
+    inline universal_packet load_record_body(
+      const uint8_t* in, size_t num_words, const ump_record_format& format, uint64_t& timestamp)
+    {
+        timestamp = 0;
+        if (format.with_timestamps)
+        {
+            timestamp = load_u64(in, format.order);
+            in += 8;
+        }
+
+        universal_packet result;
+        for (auto w = 0u; w < num_words; ++w, in += 4)
+            result.data[w] = load_u32(in, format.order);
+        return result;
+    }
+
+    //! a record is valid if the word count matches the size of the packet type
+    inline bool is_valid_record(size_t num_words, const universal_packet& p)
+    {
+        return (num_words == p.size());
+    }
+
+} // namespace
+
+//--------------------------------------------------------------------------
+
+size_t write_ump_record_header(const ump_record_format& format, uint8_t* out, size_t out_size)
+{
+    assert(out != nullptr);
+
+    if (out_size < ump_record_header_size)
+        return 0;
+
+    out[0] = record_magic[0];
+    out[1] = record_magic[1];
+    out[2] = record_magic[2];
+    out[3] = record_magic[3];
+    out[4] = ump_record_format_version;
+    out[5] = ((format.order == byte_order::big_endian) ? record_flag_big_endian : 0) |
+             (format.with_timestamps ? record_flag_timestamps : 0);
+    out[6] = 0;
+    out[7] = 0;
+
+    return ump_record_header_size;
+}
+
+//--------------------------------------------------------------------------
+
+std::optional<ump_record_format> read_ump_record_header(const uint8_t* in, size_t in_size)
+{
+    if (in_size < ump_record_header_size || (in[0] != record_magic[0]) || (in[1] != record_magic[1]) ||
+        (in[2] != record_magic[2]) || (in[3] != record_magic[3]) || (in[4] != ump_record_format_version))
+        return std::nullopt;
+
+    ump_record_format result;
+    result.order           = (in[5] & record_flag_big_endian) ? byte_order::big_endian : byte_order::little_endian;
+    result.with_timestamps = (in[5] & record_flag_timestamps) != 0;
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+size_t write_ump_records(const ump_record_format& format,
+                         const universal_packet*  packets,
+                         const uint64_t*          timestamps,
+                         size_t                   num_packets,
+                         uint8_t*                 out,
+                         size_t                   out_size,
+                         size_t&                  num_written)
+{
+    assert(packets || !num_packets);
+    assert(out || !out_size);
+
+    size_t pos  = 0;
+    num_written = 0;
+
+    for (; num_written < num_packets; ++num_written)
+    {
+        const auto& p         = packets[num_written];
+        const auto  num_words = p.size();
+
+        if (pos + format.record_size(p) > out_size)
+            break;
+
+        out[pos++] = uint8_t(num_words);
+        if (format.with_timestamps)
+        {
+            store_u64(out + pos, timestamps ? timestamps[num_written] : 0, format.order);
+            pos += 8;
+        }
+        for (auto w = 0u; w < num_words; ++w, pos += 4)
+            store_u32(out + pos, p.data[w], format.order);
+    }
+
+    return pos;
+}
+
+//--------------------------------------------------------------------------
+
+size_t read_ump_records(const ump_record_format& format,
+                        const uint8_t*           in,
+                        size_t                   in_size,
+                        universal_packet*        packets,
+                        uint64_t*                timestamps,
+                        size_t                   max_packets,
+                        size_t&                  num_read)
+{
+    assert(in || !in_size);
+    assert(packets || !max_packets);
+
+    const size_t timestamp_size = format.with_timestamps ? 8 : 0;
+
+    size_t pos = 0;
+    num_read   = 0;
+
+    while ((num_read < max_packets) && (pos < in_size))
+    {
+        const size_t num_words = in[pos];
+        if ((num_words < 1) || (num_words > 4) || (pos + 1 + timestamp_size + num_words * 4 > in_size))
+            break;
+
+        uint64_t   timestamp;
+        const auto p = load_record_body(in + pos + 1, num_words, format, timestamp);
+        if (!is_valid_record(num_words, p))
+            break;
+
+        if (timestamps)
+            timestamps[num_read] = timestamp;
+        packets[num_read++] = p;
+        pos += 1 + timestamp_size + num_words * 4;
+    }
+
+    return pos;
+}
+
+//--------------------------------------------------------------------------
+
+bool write_ump_record_header(std::FILE* file, const ump_record_format& format)
+{
+    assert(file != nullptr);
+
+    uint8_t header[ump_record_header_size];
+    write_ump_record_header(format, header, sizeof(header));
+    return std::fwrite(header, 1, sizeof(header), file) == sizeof(header);
+}
+
+//--------------------------------------------------------------------------
+
+std::optional<ump_record_format> read_ump_record_header(std::FILE* file)
+{
+    assert(file != nullptr);
+
+    uint8_t header[ump_record_header_size];
+    if (std::fread(header, 1, sizeof(header), file) != sizeof(header))
+        return std::nullopt;
+    return read_ump_record_header(header, sizeof(header));
+}
+
+//--------------------------------------------------------------------------
+
+size_t write_ump_records(std::FILE*               file,
+                         const ump_record_format& format,
+                         const universal_packet*  packets,
+                         const uint64_t*          timestamps,
+                         size_t                   num_packets)
+{
+    assert(file != nullptr);
+
+    uint8_t chunk[record_file_chunk_size];
+
+    size_t result = 0;
+    while (result < num_packets)
+    {
+        size_t     num_written = 0;
+        const auto num_bytes   = write_ump_records(format,
+                                                 packets + result,
+                                                 timestamps ? timestamps + result : nullptr,
+                                                 num_packets - result,
+                                                 chunk,
+                                                 sizeof(chunk),
+                                                 num_written);
+
+        if (std::fwrite(chunk, 1, num_bytes, file) != num_bytes)
+            break;
+        result += num_written;
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+size_t read_ump_records(
+  std::FILE* file, const ump_record_format& format, universal_packet* packets, uint64_t* timestamps, size_t max_packets)
+{
+    assert(file != nullptr);
+
+    const size_t timestamp_size = format.with_timestamps ? 8 : 0;
+
+    uint8_t record[1 + 8 + 16];
+
+    size_t result = 0;
+    while (result < max_packets)
+    {
+        const auto c = std::getc(file);
+        if (c == EOF)
+            break;
+        if ((c < 1) || (c > 4))
+        {
+            std::ungetc(c, file);
+            break;
+        }
+
+        const size_t num_words = size_t(c);
+        const size_t body_size = timestamp_size + num_words * 4;
+        const size_t num_bytes = std::fread(record, 1, body_size, file);
+
+        uint64_t         timestamp = 0;
+        universal_packet p;
+        if (num_bytes == body_size)
+            p = load_record_body(record, num_words, format, timestamp);
+
+        if ((num_bytes != body_size) || !is_valid_record(num_words, p))
+        {
+            // back to the start of the rejected record
+            std::clearerr(file);
+            std::fseek(file, -long(1 + num_bytes), SEEK_CUR);
+            break;
+        }
+
+        if (timestamps)
+            timestamps[result] = timestamp;
+        packets[result++] = p;
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
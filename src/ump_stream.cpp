@@ -0,0 +1,166 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <midi/ump_stream.h>
+
+//--------------------------------------------------------------------------
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define NIMIDI2_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define NIMIDI2_NEON 1
+#include <arm_neon.h>
+#endif
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+
+namespace {
+
+    //! packet sizes minus one of all 16 packet types, two bits per type
+    constexpr uint32_t packed_size_minus_one = 0xFE950D40u;
+
+    constexpr size_t packet_size_of_word(uint32_t word)
+    {
+        return 1u + ((packed_size_minus_one >> ((word >> 27u) & 0x1E)) & 0b11);
+    }
+
+    static_assert(packet_size_of_word(0x00000000u) == packet_size(packet_type::utility));
+    static_assert(packet_size_of_word(0x40000000u) == packet_size(packet_type::midi2_channel_voice));
+    static_assert(packet_size_of_word(0x50000000u) == packet_size(packet_type::extended_data));
+    static_assert(packet_size_of_word(0xB0000000u) == packet_size(packet_type(0xB)));
+    static_assert(packet_size_of_word(0xF0000000u) == packet_size(packet_type::stream));
+
+    //! extract type and group of packets [first, last) from their first words
+    void extract_type_and_group(const uint32_t* words,
+                                const uint32_t* offsets,
+                                packet_type*    types,
+                                group_t*        groups,
+                                size_t          first,
+                                size_t          last)
+    {
+        for (auto i = first; i < last; ++i)
+        {
+            const auto word = words[offsets[i]];
+            if (types)
+                types[i] = packet_type(word >> 28u);
+            if (groups)
+                groups[i] = group_t((word >> 24u) & 0x0F);
+        }
+    }
+
+} // namespace
+
+//--------------------------------------------------------------------------
+
+size_t classify_packets(const uint32_t* words,
+                        size_t          num_words,
+                        uint32_t*       offsets,
+                        packet_type*    types,
+                        group_t*        groups,
+                        size_t          max_packets)
+{
+    assert(offsets != nullptr);
+    assert(words || !num_words);
+
+    // packet boundaries depend on the size of the preceding packet, so the prefix sum
+    // is calculated sequentially (but without branching on the packet type)
+    size_t num_packets = 0;
+    size_t pos         = 0;
+    while ((num_packets < max_packets) && (pos < num_words))
+    {
+        const auto len = packet_size_of_word(words[pos]);
+        if (pos + len > num_words)
+            break; // incomplete packet
+        offsets[num_packets++] = uint32_t(pos);
+        pos += len;
+    }
+    offsets[num_packets] = uint32_t(pos);
+
+    if (!types && !groups)
+        return num_packets;
+
+    size_t i = 0;
+
+#if defined(NIMIDI2_SSE2)
+    const auto low_nibble = _mm_set1_epi8(0x0F);
+    for (; i + 16 <= num_packets; i += 16)
+    {
+        const uint32_t* o = offsets + i;
+
+        // gather first words, keep the most significant byte (type and group)
+        auto a = _mm_set_epi32(int(words[o[3]]), int(words[o[2]]), int(words[o[1]]), int(words[o[0]]));
+        auto b = _mm_set_epi32(int(words[o[7]]), int(words[o[6]]), int(words[o[5]]), int(words[o[4]]));
+        auto c = _mm_set_epi32(int(words[o[11]]), int(words[o[10]]), int(words[o[9]]), int(words[o[8]]));
+        auto d = _mm_set_epi32(int(words[o[15]]), int(words[o[14]]), int(words[o[13]]), int(words[o[12]]));
+        a      = _mm_srli_epi32(a, 24);
+        b      = _mm_srli_epi32(b, 24);
+        c      = _mm_srli_epi32(c, 24);
+        d      = _mm_srli_epi32(d, 24);
+
+        const auto bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+
+        if (types)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(types + i),
+                             _mm_and_si128(_mm_srli_epi16(bytes, 4), low_nibble));
+        if (groups)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(groups + i), _mm_and_si128(bytes, low_nibble));
+    }
+#elif defined(NIMIDI2_NEON)
+    const auto low_nibble = vdupq_n_u8(0x0F);
+    for (; i + 16 <= num_packets; i += 16)
+    {
+        const uint32_t* o = offsets + i;
+
+        uint32_t first_words[16];
+        for (auto w = 0u; w < 16; ++w)
+            first_words[w] = words[o[w]];
+
+        // keep the most significant byte (type and group)
+        const auto a = vmovn_u32(vshrq_n_u32(vld1q_u32(first_words), 24));
+        const auto b = vmovn_u32(vshrq_n_u32(vld1q_u32(first_words + 4), 24));
+        const auto c = vmovn_u32(vshrq_n_u32(vld1q_u32(first_words + 8), 24));
+        const auto d = vmovn_u32(vshrq_n_u32(vld1q_u32(first_words + 12), 24));
+
+        const auto bytes = vcombine_u8(vmovn_u16(vcombine_u16(a, b)), vmovn_u16(vcombine_u16(c, d)));
+
+        if (types)
+            vst1q_u8(reinterpret_cast<uint8_t*>(types + i), vshrq_n_u8(bytes, 4));
+        if (groups)
+            vst1q_u8(reinterpret_cast<uint8_t*>(groups + i), vandq_u8(bytes, low_nibble));
+    }
+#endif
+
+    extract_type_and_group(words, offsets, types, groups, i, num_packets);
+
+    return num_packets;
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
@@ -25,6 +25,7 @@
 //--------------------------------------------------------------------------
 
 #include <cassert>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 
@@ -49,20 +50,90 @@ namespace {
         std::ios_base::fmtflags flags = strm.flags();
     };
 
+    struct hex_conversion_tables
+    {
+        char    byte_to_hex[256][2];
+        uint8_t char_to_nibble[256]; //!< 0xFF for non hex characters
+    };
+
+    constexpr hex_conversion_tables make_hex_conversion_tables()
+    {
+        constexpr char digits[] = "0123456789abcdef";
+
+        hex_conversion_tables result{};
+        for (auto b = 0u; b < 256; ++b)
+        {
+            result.byte_to_hex[b][0] = digits[b >> 4];
+            result.byte_to_hex[b][1] = digits[b & 0x0F];
+            result.char_to_nibble[b] = 0xFF;
+        }
+        for (auto n = 0u; n < 10; ++n)
+            result.char_to_nibble['0' + n] = uint8_t(n);
+        for (auto n = 0u; n < 6; ++n)
+        {
+            result.char_to_nibble['a' + n] = uint8_t(10 + n);
+            result.char_to_nibble['A' + n] = uint8_t(10 + n);
+        }
+        return result;
+    }
+
+    constexpr hex_conversion_tables hex_tables = make_hex_conversion_tables();
+
+    inline char* format_hex_word(char* out, uint32_t w)
+    {
+        std::memcpy(out, hex_tables.byte_to_hex[w >> 24], 2);
+        std::memcpy(out + 2, hex_tables.byte_to_hex[(w >> 16) & 0xFF], 2);
+        std::memcpy(out + 4, hex_tables.byte_to_hex[(w >> 8) & 0xFF], 2);
+        std::memcpy(out + 6, hex_tables.byte_to_hex[w & 0xFF], 2);
+        return out + 8;
+    }
+
+    inline char* format_hex_packet(char* out, const universal_packet& p, size_t num_words)
+    {
+        out = format_hex_word(out, p.data[0]);
+        for (auto w = 1u; w < num_words; ++w)
+        {
+            *out++ = ' ';
+            out    = format_hex_word(out, p.data[w]);
+        }
+        return out;
+    }
+
+    constexpr size_t formatted_packet_size(size_t num_words)
+    {
+        return num_words * 9 - 1;
+    }
+
 } // namespace
 
 //--------------------------------------------------------------------------
 
 std::ostream& operator<<(std::ostream& out, const universal_packet& p)
 {
-    iobase_restore_flags flag_restorer(out);
+    constexpr auto formatting_flags =
+      std::ios_base::uppercase | std::ios_base::showbase | std::ios_base::left | std::ios_base::internal;
 
-    for (auto w = 0u; w < p.size(); ++w)
+    if (out.flags() & formatting_flags)
     {
-        if (w)
-            out << ' ';
-        out << std::hex << std::setfill('0') << std::setw(8) << p.data[w];
+        // the table driven formatter only produces the default format
+        iobase_restore_flags flag_restorer(out);
+
+        for (auto w = 0u; w < p.size(); ++w)
+        {
+            if (w)
+                out << ' ';
+            out << std::hex << std::setfill('0') << std::setw(8) << p.data[w];
+        }
+        return out;
     }
+
+    char       buffer[max_packet_chars];
+    const auto end = format_hex_packet(buffer, p, p.size());
+    out.write(buffer, end - buffer);
+
+    // leave width and fill like the formatted output does
+    out.width(0);
+    out.fill('0');
     return out;
 }
 
@@ -88,6 +159,84 @@ std::istream& operator>>(std::istream& in, universal_packet& p)
 
 //--------------------------------------------------------------------------
 
+to_chars_result to_chars(char* first, char* last, const universal_packet& p)
+{
+    assert(first <= last);
+
+    const auto num_words = p.size();
+    if (size_t(last - first) < formatted_packet_size(num_words))
+        return { last, std::errc::value_too_large };
+
+    return { format_hex_packet(first, p, num_words), std::errc{} };
+}
+
+//--------------------------------------------------------------------------
+
+to_chars_result to_chars(
+  char* first, char* last, const universal_packet* packets, size_t num_packets, char separator)
+{
+    assert(first <= last);
+    assert(packets || !num_packets);
+
+    size_t required = 0;
+    for (auto i = 0u; i < num_packets; ++i)
+        required += formatted_packet_size(packets[i].size()) + 1;
+    if (size_t(last - first) < required)
+        return { last, std::errc::value_too_large };
+
+    for (auto i = 0u; i < num_packets; ++i)
+    {
+        first    = format_hex_packet(first, packets[i], packets[i].size());
+        *first++ = separator;
+    }
+    return { first, std::errc{} };
+}
+
+//--------------------------------------------------------------------------
+
+from_chars_result from_chars(const char* first, const char* last, universal_packet& p)
+{
+    assert(first <= last);
+
+    universal_packet result;
+    const char*      pos = first;
+
+    for (size_t w = 0, num_words = 1; w < num_words; ++w)
+    {
+        if (w)
+        {
+            const auto separator = pos;
+            while ((pos != last) && ((*pos == ' ') || (*pos == '\t')))
+                ++pos;
+            if (pos == separator)
+                return { first, std::errc::invalid_argument };
+        }
+
+        const auto digits = pos;
+        uint32_t   word   = 0;
+        uint8_t    nibble = 0;
+        while ((pos != last) && ((nibble = hex_tables.char_to_nibble[uint8_t(*pos)]) != 0xFF))
+        {
+            word = (word << 4) | nibble;
+            ++pos;
+        }
+
+        if (pos == digits)
+            return { first, std::errc::invalid_argument };
+        if (pos - digits > 8)
+            return { pos, std::errc::result_out_of_range };
+
+        result.data[w] = word;
+        if (!w)
+            num_words = result.size();
+    }
+
+    p = result;
+    return { pos, std::errc{} };
+}
+
+//--------------------------------------------------------------------------
+
 } // namespace midi
 
 //--------------------------------------------------------------------------
@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <midi/usb_midi1.h>
+
+//--------------------------------------------------------------------------
+
+namespace midi {
+
+//--------------------------------------------------------------------------
+
+size_t usb_midi1_decoder::decode(const usb_midi1_event* events, size_t num_events, universal_packet* out)
+{
+    assert(out || !num_events);
+
+    size_t num_packets = 0;
+    decode(events, num_events, [out, &num_packets](const universal_packet& p) { out[num_packets++] = p; });
+    return num_packets;
+}
+
+//--------------------------------------------------------------------------
+
+void usb_midi1_decoder::reset()
+{
+    for (auto cable = 0u; cable < 16; ++cable)
+    {
+        m_sysex_status[cable] = 0;
+        m_num_bytes[cable]    = 0;
+    }
+}
+
+//--------------------------------------------------------------------------
+
+size_t usb_midi1_encoder::encode(const universal_packet* packets, size_t num_packets, usb_midi1_event* out)
+{
+    assert(packets || !num_packets);
+    assert(out || !num_packets);
+
+    size_t num_events = 0;
+    for (size_t p = 0; p < num_packets; ++p)
+        encode(packets[p], [out, &num_events](const usb_midi1_event& e) { out[num_events++] = e; });
+    return num_events;
+}
+
+//--------------------------------------------------------------------------
+
+void usb_midi1_encoder::reset()
+{
+    for (auto group = 0u; group < 16; ++group)
+        m_num_pending[group] = 0;
+}
+
+//--------------------------------------------------------------------------
+
+} // namespace midi
+
+//--------------------------------------------------------------------------
@@ -0,0 +1,222 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/controller_coalescer.h>
+
+#include <midi/midi1_channel_voice_message.h>
+#include <midi/midi2_channel_voice_message.h>
+#include <midi/system_message.h>
+
+#include <vector>
+
+//-----------------------------------------------
+
+class controller_coalescer : public ::testing::Test
+{
+  public:
+    static midi::universal_packet cc(midi::channel_t c, midi::controller_t nr, uint32_t v)
+    {
+        return midi::make_midi2_control_change_message(0, c, nr, midi::controller_value{ v });
+    }
+};
+
+//-----------------------------------------------
+
+TEST_F(controller_coalescer, coalescing_key)
+{
+    using namespace midi;
+
+    using coalescer = midi::controller_coalescer;
+
+    EXPECT_EQ(coalescer::coalescing_key(cc(1, 7, 100)), coalescer::coalescing_key(cc(1, 7, 200)));
+    EXPECT_NE(coalescer::coalescing_key(cc(1, 7, 100)), coalescer::coalescing_key(cc(2, 7, 100)));
+    EXPECT_NE(coalescer::coalescing_key(cc(1, 7, 100)), coalescer::coalescing_key(cc(1, 8, 100)));
+    EXPECT_NE(coalescer::coalescing_key(cc(1, 7, 100)),
+              coalescer::coalescing_key(make_midi1_control_change_message(0, 1, 7, controller_value{ uint7_t{ 1 } })));
+
+    EXPECT_EQ(coalescer::coalescing_key(make_per_note_pitch_bend_message(0, 0, 60, pitch_bend{ 0.5f })),
+              coalescer::coalescing_key(make_per_note_pitch_bend_message(0, 0, 60, pitch_bend{ -0.5f })));
+    EXPECT_NE(coalescer::coalescing_key(make_per_note_pitch_bend_message(0, 0, 60, pitch_bend{ 0.5f })),
+              coalescer::coalescing_key(make_per_note_pitch_bend_message(0, 0, 61, pitch_bend{ 0.5f })));
+    EXPECT_NE(coalescer::coalescing_key(make_registered_controller_message(0, 0, 0, 1, controller_value{ 1u })),
+              coalescer::coalescing_key(make_registered_controller_message(0, 0, 0, 2, controller_value{ 1u })));
+    EXPECT_NE(0u, coalescer::coalescing_key(make_midi1_pitch_bend_message(0, 0, pitch_bend{ 0.5f })));
+    EXPECT_NE(0u, coalescer::coalescing_key(make_midi2_channel_pressure_message(0, 0, controller_value{ 1u })));
+
+    // not coalesced
+    EXPECT_EQ(0u, coalescer::coalescing_key(make_midi2_note_on_message(0, 0, 60, velocity{ 0.5f })));
+    EXPECT_EQ(0u, coalescer::coalescing_key(make_midi2_program_change_message(0, 0, 1)));
+    const auto relative = make_relative_registered_controller_message(0, 0, 0, 1, controller_increment{ 1 });
+    EXPECT_EQ(0u, coalescer::coalescing_key(relative));
+    EXPECT_EQ(0u, coalescer::coalescing_key(cc(0, control_change::bank_select_msb, 0)));
+    EXPECT_EQ(0u,
+              coalescer::coalescing_key(
+                make_midi1_control_change_message(0, 0, control_change::data_entry_msb, controller_value{ 1u })));
+    EXPECT_EQ(0u, coalescer::coalescing_key(make_system_message(0, system_status::clock)));
+}
+
+//-----------------------------------------------
+
+TEST_F(controller_coalescer, flush_block)
+{
+    using namespace midi;
+
+    std::vector<universal_packet> out;
+    const auto                    sink = [&](const universal_packet& p) { out.push_back(p); };
+
+    midi::controller_coalescer c;
+    for (uint32_t v = 0; v < 100; ++v)
+    {
+        c.push(cc(0, 7, v), sink);
+        c.push(cc(0, 10, v * 2), sink);
+        c.push(cc(1, 7, v * 3), sink);
+    }
+    c.push(make_system_message(0, system_status::clock), sink);
+
+    EXPECT_EQ(std::vector<universal_packet>{ make_system_message(0, system_status::clock) }, out);
+    EXPECT_EQ(3u, c.size());
+
+    out.clear();
+    EXPECT_EQ(3u, c.flush(sink));
+    EXPECT_TRUE(c.empty());
+
+    // order of first arrival
+    const std::vector<universal_packet> expected = { cc(0, 7, 99), cc(0, 10, 198), cc(1, 7, 297) };
+    EXPECT_EQ(expected, out);
+}
+
+//-----------------------------------------------
+
+TEST_F(controller_coalescer, note_ordering)
+{
+    using namespace midi;
+
+    std::vector<universal_packet> out;
+    const auto                    sink = [&](const universal_packet& p) { out.push_back(p); };
+
+    const auto pb        = make_midi2_pitch_bend_message(0, 0, pitch_bend{ 0.25f });
+    const auto other_pb  = make_midi2_pitch_bend_message(0, 1, pitch_bend{ 0.25f });
+    const auto note_on   = make_midi2_note_on_message(0, 0, 60, velocity{ 0.5f });
+    const auto note_off  = make_midi2_note_off_message(0, 0, 60, velocity{ 0.5f });
+    const auto pressure1 = make_midi2_poly_pressure_message(0, 0, 60, controller_value{ 1u });
+    const auto pressure2 = make_midi2_poly_pressure_message(0, 0, 60, controller_value{ 2u });
+
+    midi::controller_coalescer c;
+    c.push(other_pb, sink);
+    c.push(pb, sink);
+    c.push(note_on, sink);
+    c.push(pressure1, sink);
+    c.push(pressure2, sink);
+    c.push(note_off, sink);
+
+    const std::vector<universal_packet> expected = { pb, note_on, pressure2, note_off };
+    EXPECT_EQ(expected, out);
+
+    // other channel still pending
+    out.clear();
+    EXPECT_EQ(1u, c.flush(sink));
+    EXPECT_EQ(std::vector<universal_packet>{ other_pb }, out);
+}
+
+//-----------------------------------------------
+
+TEST_F(controller_coalescer, channel_mode_ordering)
+{
+    using namespace midi;
+
+    std::vector<universal_packet> out;
+    const auto                    sink = [&](const universal_packet& p) { out.push_back(p); };
+
+    const auto reset   = cc(0, control_change::reset_all_controllers, 0);
+    const auto reset_1 = make_midi1_control_change_message(0, 0, control_change::all_notes_off, controller_value{ 0u });
+    EXPECT_EQ(0u, midi::controller_coalescer::coalescing_key(reset));
+    EXPECT_EQ(0u, midi::controller_coalescer::coalescing_key(reset_1));
+
+    midi::controller_coalescer c;
+    c.push(cc(0, 7, 100), sink);
+    c.push(reset, sink);
+    c.push(cc(0, 7, 50), sink);
+    c.flush(sink);
+
+    const std::vector<universal_packet> expected = { cc(0, 7, 100), reset, cc(0, 7, 50) };
+    EXPECT_EQ(expected, out);
+}
+
+//-----------------------------------------------
+
+TEST_F(controller_coalescer, flush_window)
+{
+    using namespace midi;
+
+    std::vector<universal_packet> out;
+    const auto                    sink = [&](const universal_packet& p) { out.push_back(p); };
+
+    midi::controller_coalescer c{ 256, 1000 };
+    EXPECT_EQ(1000u, c.window_us());
+
+    c.push(cc(0, 1, 1), 0, sink);
+    c.push(cc(0, 2, 1), 500, sink);
+    c.push(cc(0, 1, 2), 900, sink);
+
+    EXPECT_EQ(0u, c.flush(999, sink));
+    EXPECT_EQ(1u, c.flush(1000, sink));
+    EXPECT_EQ(std::vector<universal_packet>{ cc(0, 1, 2) }, out);
+
+    c.push(cc(0, 1, 3), 1200, sink);
+    out.clear();
+    EXPECT_EQ(1u, c.flush(1500, sink));
+    EXPECT_EQ(std::vector<universal_packet>{ cc(0, 2, 1) }, out);
+
+    out.clear();
+    EXPECT_EQ(1u, c.flush(2200, sink));
+    EXPECT_EQ(std::vector<universal_packet>{ cc(0, 1, 3) }, out);
+    EXPECT_TRUE(c.empty());
+}
+
+//-----------------------------------------------
+
+TEST_F(controller_coalescer, capacity)
+{
+    using namespace midi;
+
+    std::vector<universal_packet> out;
+    const auto                    sink = [&](const universal_packet& p) { out.push_back(p); };
+
+    midi::controller_coalescer c{ 2 };
+    EXPECT_EQ(2u, c.capacity());
+
+    c.push(cc(0, 1, 1), sink);
+    c.push(cc(0, 2, 1), sink);
+    c.push(cc(0, 2, 2), sink);
+    EXPECT_TRUE(out.empty());
+
+    // passed on when full
+    c.push(cc(0, 3, 1), sink);
+    EXPECT_EQ(std::vector<universal_packet>{ cc(0, 3, 1) }, out);
+
+    c.clear();
+    EXPECT_TRUE(c.empty());
+}
+
+//-----------------------------------------------
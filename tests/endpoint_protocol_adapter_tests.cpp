@@ -0,0 +1,204 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/endpoint_protocol_adapter.h>
+
+#include <midi/channel_voice_message.h>
+#include <midi/jitter_reduction_timestamps.h>
+#include <midi/midi1_channel_voice_message.h>
+#include <midi/midi2_channel_voice_message.h>
+#include <midi/stream_message.h>
+#include <midi/system_message.h>
+#include <midi/utility_message.h>
+
+#include <iterator>
+#include <vector>
+
+//-----------------------------------------------
+
+class endpoint_protocol_adapter : public ::testing::Test
+{
+  public:
+    static std::vector<midi::universal_packet> adapt(midi::endpoint_protocol_adapter& a,
+                                                     const midi::universal_packet&    p)
+    {
+        std::vector<midi::universal_packet> result;
+        a.adapt(p, [&](const midi::universal_packet& out) { result.push_back(out); });
+        return result;
+    }
+};
+
+//-----------------------------------------------
+
+TEST_F(endpoint_protocol_adapter, stream_configuration)
+{
+    using namespace midi;
+
+    midi::endpoint_protocol_adapter a;
+    EXPECT_EQ(protocol::midi1, a.protocol());
+    EXPECT_EQ(0u, a.extensions());
+
+    // requests are sent to the endpoint, only notifications change the configuration
+    EXPECT_FALSE(a.process_endpoint_packet(make_stream_configuration_request(protocol::midi2)));
+    EXPECT_EQ(protocol::midi1, a.protocol());
+
+    EXPECT_TRUE(a.process_endpoint_packet(
+      make_stream_configuration_notification(protocol::midi2, extensions::jitter_reduction_receive)));
+    EXPECT_EQ(protocol::midi2, a.protocol());
+    EXPECT_EQ(extensions::jitter_reduction_receive, a.extensions());
+    EXPECT_FALSE(a.process_endpoint_packet(
+      make_stream_configuration_notification(protocol::midi2, extensions::jitter_reduction_receive)));
+
+    EXPECT_TRUE(a.process_endpoint_packet(make_stream_configuration_notification(protocol::midi2)));
+    EXPECT_EQ(0u, a.extensions());
+
+    // invalid protocol
+    auto invalid = make_stream_configuration_notification(protocol::midi1);
+    invalid.set_byte(2, 0x3);
+    EXPECT_FALSE(a.process_endpoint_packet(invalid));
+    EXPECT_EQ(protocol::midi2, a.protocol());
+
+    EXPECT_FALSE(a.process_endpoint_packet(make_midi2_note_on_message(0, 0, 60, velocity{ uint7_t{ 100 } })));
+}
+
+//-----------------------------------------------
+
+TEST_F(endpoint_protocol_adapter, group_protocol)
+{
+    using namespace midi;
+
+    midi::endpoint_protocol_adapter a{ protocol::midi2 };
+    for (group_t g = 0; g < 16; ++g)
+        EXPECT_EQ(protocol::midi2, a.group_protocol(g));
+
+    function_block_options midi1;
+    midi1.midi1 = function_block_options::midi1_31250;
+
+    EXPECT_TRUE(a.process_endpoint_packet(make_function_block_info_message(1, midi1, 2, 2)));
+    EXPECT_FALSE(a.process_endpoint_packet(make_function_block_info_message(1, midi1, 2, 2)));
+    EXPECT_TRUE(a.process_endpoint_packet(make_function_block_info_message(0, midi1, 14, 4)));
+    for (group_t g = 0; g < 16; ++g)
+    {
+        const bool is_midi1 = (g == 2) || (g == 3) || (g >= 14);
+        EXPECT_EQ(is_midi1 ? protocol::midi1 : protocol::midi2, a.group_protocol(g)) << "group " << int(g);
+    }
+
+    // function block no longer MIDI 1
+    EXPECT_TRUE(a.process_endpoint_packet(
+      make_function_block_info_message(1, function_block_options::bidirectional, 2, 2)));
+    EXPECT_EQ(protocol::midi2, a.group_protocol(2));
+    EXPECT_EQ(protocol::midi1, a.group_protocol(14));
+
+    // inactive function block
+    midi1.active = false;
+    EXPECT_TRUE(a.process_endpoint_packet(make_function_block_info_message(0, midi1, 14, 4)));
+    EXPECT_EQ(protocol::midi2, a.group_protocol(14));
+
+    EXPECT_TRUE(a.process_endpoint_packet(make_stream_configuration_notification(protocol::midi1)));
+    for (group_t g = 0; g < 16; ++g)
+        EXPECT_EQ(protocol::midi1, a.group_protocol(g));
+}
+
+//-----------------------------------------------
+
+TEST_F(endpoint_protocol_adapter, adapt_channel_voice_messages)
+{
+    using namespace midi;
+
+    const auto m1 = make_midi1_note_on_message(3, 1, 60, velocity{ uint7_t{ 100 } });
+    const auto m2 = make_midi2_note_on_message(3, 1, 60, velocity{ uint7_t{ 100 } });
+    const auto rc = make_registered_controller_message(3, 1, 0, 0, controller_value{ uint7_t{ 2 } });
+
+    midi::endpoint_protocol_adapter a;
+    EXPECT_EQ(std::vector<universal_packet>{ m1 }, adapt(a, m1));
+    EXPECT_EQ(std::vector<universal_packet>{ m1 }, adapt(a, m2));
+    EXPECT_EQ(4u, adapt(a, rc).size());
+    EXPECT_EQ(2u, adapt(a, rc).size());
+
+    a.process_endpoint_packet(make_stream_configuration_notification(protocol::midi2));
+    EXPECT_EQ(std::vector<universal_packet>{ m2 }, adapt(a, m1));
+    EXPECT_EQ(std::vector<universal_packet>{ m2 }, adapt(a, m2));
+    EXPECT_EQ(std::vector<universal_packet>{ rc }, adapt(a, rc));
+
+    function_block_options midi1;
+    midi1.midi1 = function_block_options::midi1_unrestricted;
+    a.process_endpoint_packet(make_function_block_info_message(0, midi1, 3));
+
+    EXPECT_EQ(std::vector<universal_packet>{ m1 }, adapt(a, m2));
+    EXPECT_EQ(4u, adapt(a, rc).size()) << "parameter selection sent again after protocol change";
+
+    const auto other_group = make_midi2_note_on_message(4, 1, 60, velocity{ uint7_t{ 100 } });
+    EXPECT_EQ(std::vector<universal_packet>{ other_group }, adapt(a, other_group));
+}
+
+//-----------------------------------------------
+
+TEST_F(endpoint_protocol_adapter, jitter_reduction)
+{
+    using namespace midi;
+
+    const universal_packet jr_clock      = jr_clock_message{ jr_timestamp_t{ 0x1234 } };
+    const universal_packet jr_timestamp  = jr_timestamp_message{ jr_timestamp_t{ 0x5678 } };
+    const universal_packet noop          = make_utility_message(utility_status::noop, 0);
+    const universal_packet timing_clock  = make_system_message(0, system_status::clock);
+    const universal_packet configuration = make_stream_configuration_request(protocol::midi2);
+
+    midi::endpoint_protocol_adapter a{ protocol::midi2 };
+    EXPECT_TRUE(adapt(a, jr_clock).empty());
+    EXPECT_TRUE(adapt(a, jr_timestamp).empty());
+    EXPECT_EQ(std::vector<universal_packet>{ noop }, adapt(a, noop));
+    EXPECT_EQ(std::vector<universal_packet>{ timing_clock }, adapt(a, timing_clock));
+    EXPECT_EQ(std::vector<universal_packet>{ configuration }, adapt(a, configuration));
+
+    a.process_endpoint_packet(
+      make_stream_configuration_notification(protocol::midi2, extensions::jitter_reduction_receive));
+    EXPECT_EQ(std::vector<universal_packet>{ jr_clock }, adapt(a, jr_clock));
+    EXPECT_EQ(std::vector<universal_packet>{ jr_timestamp }, adapt(a, jr_timestamp));
+}
+
+//-----------------------------------------------
+
+TEST_F(endpoint_protocol_adapter, adapt_bulk)
+{
+    using namespace midi;
+
+    const universal_packet packets[] = {
+        make_midi2_note_on_message(0, 0, 60, velocity{ uint7_t{ 100 } }),
+        jr_clock_message{ jr_timestamp_t{ 0x1234 } },
+        make_midi2_program_change_message(0, 0, 5, uint14_t{ 0x0102 }),
+        make_midi1_note_off_message(0, 0, 60, velocity{ uint7_t{ 0 } }),
+    };
+
+    midi::endpoint_protocol_adapter a;
+
+    universal_packet out[std::size(packets) * midi::endpoint_protocol_adapter::max_packets_per_packet];
+    ASSERT_EQ(5u, a.adapt(packets, std::size(packets), out));
+    EXPECT_EQ(make_midi1_note_on_message(0, 0, 60, velocity{ uint7_t{ 100 } }), out[0]);
+    const auto bank_msb = controller_value{ uint7_t{ 2 } };
+    EXPECT_EQ(make_midi1_control_change_message(0, 0, control_change::bank_select_msb, bank_msb), out[1]);
+    EXPECT_EQ(make_midi1_program_change_message(0, 0, 5), out[3]);
+    EXPECT_EQ(packets[3], out[4]);
+}
+
+//-----------------------------------------------
@@ -30,6 +30,8 @@
 #include <midi/system_message.h>
 
 #include <functional>
+#include <iterator>
+#include <vector>
 
 //-----------------------------------------------
 
@@ -68,9 +70,9 @@ TEST_F(midi1_byte_stream, parser_constructors)
 
         midi::midi1_byte_stream_parser p(
           5,
-          [&num_callbacks](midi::universal_packet p) {
+          [&num_callbacks](midi::universal_packet packet) {
               ++num_callbacks;
-              EXPECT_EQ(5u, p.group());
+              EXPECT_EQ(5u, packet.group());
           },
           {},
           true);
@@ -89,9 +91,9 @@ TEST_F(midi1_byte_stream, parser_group)
     unsigned num_callbacks = 0;
 
     midi::midi1_byte_stream_parser p(
-      [&num_callbacks](midi::universal_packet p) {
+      [&num_callbacks](midi::universal_packet packet) {
           ++num_callbacks;
-          EXPECT_EQ(9u, p.group());
+          EXPECT_EQ(9u, packet.group());
       },
       {},
       true);
@@ -857,10 +859,10 @@ TEST_F(midi1_byte_stream, parser_no_sysex_callback)
     const midi::universal_packet packets[] = {
         midi::make_midi1_channel_voice_message(0, midi::midi1_channel_voice_status::note_off, 3, 0x45, 0x6E),
         []() {
-            auto p = midi::make_sysex7_complete_packet(0);
-            p.add_payload_byte(0x01);
-            p.add_payload_byte(0x02);
-            return p;
+            auto sysex = midi::make_sysex7_complete_packet(0);
+            sysex.add_payload_byte(0x01);
+            sysex.add_payload_byte(0x02);
+            return sysex;
         }(),
         midi::make_midi1_channel_voice_message(0, midi::midi1_channel_voice_status::note_on, 14, 0x30, 0x7F)
     };
@@ -904,6 +906,369 @@ TEST_F(midi1_byte_stream, parser_large_sysex)
 
 //-----------------------------------------------
 
+TEST_F(midi1_byte_stream, parser_bulk_feed_matches_single_byte_feed)
+{
+    std::vector<std::uint8_t> byte_stream = { 0x90, 0x3C, 0x40, 0x3E, 0x40, 0xF0, 0x00, 0x21, 0x09 };
+    for (auto i = 0u; i < 100; ++i)
+    {
+        byte_stream.push_back(std::uint8_t(i & 0x7F));
+        if (i % 37 == 0)
+            byte_stream.push_back(0xF8); // realtime inside SysEx
+    }
+    const std::vector<std::uint8_t> tail = { 0xF7, 0xF0, 0x7D, 0x01, 0x02, 0xF7, 0xB0, 0x07, 0x10, 0xF0, 0x00, 0x01 };
+    byte_stream.insert(byte_stream.end(), tail.begin(), tail.end());
+    for (auto i = 0u; i < 20; ++i)
+        byte_stream.push_back(std::uint8_t(0x40 + i));
+    byte_stream.push_back(0xF7);
+
+    for (const bool with_sysex_callback : { false, true })
+    {
+        std::vector<midi::universal_packet> expected_packets;
+        std::vector<midi::sysex7>           expected_sysex;
+        {
+            midi::midi1_byte_stream_parser::sysex_callback sysex_cb;
+            if (with_sysex_callback)
+                sysex_cb = [&](const midi::sysex7& sx) { expected_sysex.push_back(sx); };
+            midi::midi1_byte_stream_parser p(
+              [&](midi::universal_packet packet) { expected_packets.push_back(packet); }, sysex_cb);
+            for (const auto b : byte_stream)
+                p.feed(b);
+        }
+        EXPECT_FALSE(expected_packets.empty());
+
+        // split the stream at every position
+        for (auto split = 0u; split <= byte_stream.size(); ++split)
+        {
+            std::vector<midi::universal_packet> packets;
+            std::vector<midi::sysex7>           sysex;
+
+            midi::midi1_byte_stream_parser::sysex_callback sysex_cb;
+            if (with_sysex_callback)
+                sysex_cb = [&](const midi::sysex7& sx) { sysex.push_back(sx); };
+            midi::midi1_byte_stream_parser p([&](midi::universal_packet packet) { packets.push_back(packet); },
+                                             sysex_cb);
+
+            p.feed(byte_stream.data(), split);
+            p.feed(byte_stream.data() + split, byte_stream.data() + byte_stream.size());
+
+            EXPECT_EQ(expected_packets, packets);
+            EXPECT_EQ(expected_sysex, sysex);
+        }
+    }
+}
+
+//-----------------------------------------------
+
+TEST_F(midi1_byte_stream, basic_parser_with_lambdas)
+{
+    constexpr std::uint8_t byte_stream[] = { 0x90, 0x3C, 0x40, 0xF0, 0x7D, 0x01, 0x02, 0xF8, 0x03, 0xF7, 0x3E, 0x40 };
+
+    std::vector<midi::universal_packet> packets;
+    std::vector<midi::sysex7>           sysex;
+
+    auto on_packet = [&](midi::universal_packet p) { packets.push_back(p); };
+    auto on_sysex  = [&](const midi::sysex7& sx) { sysex.push_back(sx); };
+
+    {
+        midi::basic_midi1_byte_stream_parser<decltype(on_packet)> p{ on_packet };
+        p.feed(byte_stream, sizeof(byte_stream));
+
+        const midi::universal_packet expected[] = {
+            midi::make_midi1_channel_voice_message(0, midi::midi1_channel_voice_status::note_on, 0, 0x3C, 0x40),
+            midi::make_system_message(0, midi::system_status::clock),
+            { 0x30047D01, 0x02030000 },
+        };
+        EXPECT_EQ(std::vector<midi::universal_packet>(std::begin(expected), std::end(expected)), packets);
+        EXPECT_TRUE(sysex.empty());
+    }
+
+    packets.clear();
+
+    {
+        midi::basic_midi1_byte_stream_parser<decltype(on_packet), decltype(on_sysex)> p{ 3, on_packet, on_sysex };
+        EXPECT_EQ(3u, p.group());
+        p.feed(byte_stream, sizeof(byte_stream));
+        p.feed(0x90);
+        p.feed(0x3E);
+        p.feed(0x40);
+
+        const midi::universal_packet expected[] = {
+            midi::make_midi1_channel_voice_message(3, midi::midi1_channel_voice_status::note_on, 0, 0x3C, 0x40),
+            midi::make_system_message(3, midi::system_status::clock),
+            midi::make_midi1_channel_voice_message(3, midi::midi1_channel_voice_status::note_on, 0, 0x3E, 0x40),
+        };
+        EXPECT_EQ(std::vector<midi::universal_packet>(std::begin(expected), std::end(expected)), packets);
+        ASSERT_EQ(1u, sysex.size());
+        EXPECT_EQ((midi::sysex7{ midi::manufacturer::educational, midi::sysex::data_type{ 0x01, 0x02, 0x03 } }),
+                  sysex[0]);
+    }
+}
+
+//-----------------------------------------------
+
+TEST_F(midi1_byte_stream, basic_parser_with_function_pointers)
+{
+    static int num_packets = 0;
+
+    using packet_function = void (*)(midi::universal_packet);
+    using sysex_function  = void (*)(const midi::sysex7&);
+
+    midi::basic_midi1_byte_stream_parser<packet_function, sysex_function> p{ [](midi::universal_packet) {
+                                                                                 ++num_packets;
+                                                                             },
+                                                                             nullptr };
+
+    // no SysEx function, SysEx is delivered as packets
+    constexpr std::uint8_t byte_stream[] = { 0xF0, 0x7D, 0x01, 0xF7, 0xC0, 0x10 };
+    p.feed(byte_stream, sizeof(byte_stream));
+    EXPECT_EQ(2, num_packets);
+}
+
+//-----------------------------------------------
+
+TEST_F(midi1_byte_stream, parser_parse_into_buffer)
+{
+    std::vector<std::uint8_t> byte_stream = { 0x90, 0x3C, 0x40, 0x3E, 0x40, 0xF8, 0xF0, 0x7D };
+    for (auto i = 0u; i < 40; ++i)
+        byte_stream.push_back(std::uint8_t(i));
+    const std::vector<std::uint8_t> tail = { 0xF7, 0xB0, 0x07, 0x10, 0x0A, 0x20, 0xF6, 0xC3, 0x05 };
+    byte_stream.insert(byte_stream.end(), tail.begin(), tail.end());
+
+    std::vector<midi::universal_packet> expected;
+    {
+        midi::midi1_byte_stream_parser p([&](midi::universal_packet packet) { expected.push_back(packet); });
+        p.feed(byte_stream.data(), byte_stream.size());
+    }
+    ASSERT_EQ(14u, expected.size());
+
+    for (const size_t capacity : { 1u, 2u, 3u, 7u, 64u })
+    {
+        midi::basic_midi1_byte_stream_parser<std::nullptr_t> p{ nullptr };
+
+        std::vector<midi::universal_packet> packets;
+        std::vector<midi::universal_packet> buffer(capacity);
+
+        const std::uint8_t* in        = byte_stream.data();
+        size_t              remaining = byte_stream.size();
+        while (remaining)
+        {
+            size_t     consumed = 0;
+            const auto n        = p.parse(in, remaining, buffer.data(), buffer.size(), consumed);
+            EXPECT_LE(n, capacity);
+            EXPECT_LE(consumed, remaining);
+            EXPECT_TRUE(consumed == remaining || n == capacity);
+            packets.insert(packets.end(), buffer.begin(), buffer.begin() + std::ptrdiff_t(n));
+            in += consumed;
+            remaining -= consumed;
+        }
+
+        EXPECT_EQ(expected, packets);
+    }
+
+    // callbacks are not invoked while parsing into a buffer
+    {
+        size_t                         num_callbacks = 0;
+        midi::midi1_byte_stream_parser p([&](midi::universal_packet) { ++num_callbacks; });
+
+        midi::universal_packet buffer[2];
+        size_t                 consumed = 0;
+        EXPECT_EQ(2u, p.parse(byte_stream.data(), byte_stream.size(), buffer, 2, consumed));
+        EXPECT_EQ(5u, consumed);
+        EXPECT_EQ(0u, num_callbacks);
+        EXPECT_EQ(expected[0], buffer[0]);
+        EXPECT_EQ(expected[1], buffer[1]);
+
+        // no room, nothing consumed
+        EXPECT_EQ(0u, p.parse(byte_stream.data() + 5, 1, buffer, 0, consumed));
+        EXPECT_EQ(0u, consumed);
+
+        p.feed(byte_stream.data() + 5, 1);
+        EXPECT_EQ(1u, num_callbacks);
+    }
+}
+
+//-----------------------------------------------
+
+TEST_F(midi1_byte_stream, parser_sysex_chunks)
+{
+    std::vector<std::uint8_t> byte_stream = { 0xF0, 0x00, 0x21, 0x09 };
+    for (auto i = 0u; i < 1000; ++i)
+    {
+        byte_stream.push_back(std::uint8_t(i & 0x7F));
+        if (i % 101 == 0)
+            byte_stream.push_back(0xF8); // realtime inside SysEx
+    }
+    const std::vector<std::uint8_t> tail = { 0xF7, 0xF0, 0x7D, 0x01, 0x02, 0xF7, 0xF0, 0x7D, 0xF7 };
+    byte_stream.insert(byte_stream.end(), tail.begin(), tail.end());
+
+    std::vector<midi::sysex7> expected;
+    {
+        midi::midi1_byte_stream_parser p([](midi::universal_packet) {},
+                                         [&](const midi::sysex7& sx) { expected.push_back(sx); });
+        p.feed(byte_stream.data(), byte_stream.size());
+    }
+    ASSERT_EQ(3u, expected.size());
+
+    for (const bool bulk : { false, true })
+    {
+        std::vector<midi::sysex7>        sysex;
+        std::vector<midi::packet_format> formats;
+        size_t                           num_clocks = 0;
+
+        auto on_packet = [&](midi::universal_packet) { ++num_clocks; };
+        auto on_chunk  = [&](const midi::sysex7_chunk& chunk) {
+            EXPECT_LE(chunk.size, 64u);
+            if ((chunk.format == midi::packet_format::start) || (chunk.format == midi::packet_format::complete))
+                sysex.emplace_back(chunk.manufacturerID);
+            ASSERT_FALSE(sysex.empty());
+            EXPECT_EQ(sysex.back().manufacturerID, chunk.manufacturerID);
+            sysex.back().data.insert(sysex.back().data.end(), chunk.data, chunk.data + chunk.size);
+            formats.push_back(chunk.format);
+        };
+
+        midi::basic_midi1_byte_stream_parser<decltype(on_packet), decltype(on_chunk)> p{ on_packet, on_chunk };
+        EXPECT_EQ(256u, p.sysex_chunk_size());
+        p.set_sysex_chunk_size(64);
+        EXPECT_EQ(64u, p.sysex_chunk_size());
+
+        if (bulk)
+        {
+            p.feed(byte_stream.data(), byte_stream.size());
+        }
+        else
+        {
+            for (const auto b : byte_stream)
+                p.feed(b);
+        }
+
+        EXPECT_EQ(expected, sysex);
+        EXPECT_EQ(10u, num_clocks);
+
+        // 1000 bytes in 64 byte chunks, followed by two complete messages
+        ASSERT_EQ(18u, formats.size());
+        EXPECT_EQ(midi::packet_format::start, formats[0]);
+        for (auto i = 1u; i < 15; ++i)
+            EXPECT_EQ(midi::packet_format::cont, formats[i]);
+        EXPECT_EQ(midi::packet_format::end, formats[15]);
+        EXPECT_EQ(midi::packet_format::complete, formats[16]);
+        EXPECT_EQ(midi::packet_format::complete, formats[17]);
+    }
+}
+
+//-----------------------------------------------
+
+TEST_F(midi1_byte_stream, serializer_running_status)
+{
+    using namespace midi;
+
+    const universal_packet packets[] = {
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::control_change, 0, 0x07, 0x10),
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::control_change, 0, 0x0A, 0x20),
+        make_system_message(0, system_status::clock), // does not cancel running status
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::control_change, 0, 0x0B, 0x30),
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::control_change, 1, 0x0B, 0x30),
+        make_system_message(0, system_status::tune_request), // cancels running status
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::control_change, 1, 0x0B, 0x31),
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::program_change, 1, 0x05, 0),
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::program_change, 1, 0x06, 0),
+        { 0x30037D01, 0x02000000 }, // cancels running status
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::program_change, 1, 0x07, 0),
+        { 0x40903C00, 0xFFFF0000 }, // ignored
+    };
+
+    const std::vector<std::uint8_t> expected = { 0xB0, 0x07, 0x10, 0x0A, 0x20, 0xF8, 0x0B, 0x30, 0xB1, 0x0B, 0x30,
+                                                 0xF6, 0xB1, 0x0B, 0x31, 0xC1, 0x05, 0x06, 0xF0, 0x7D, 0x01, 0x02,
+                                                 0xF7, 0xC1, 0x07 };
+
+    midi1_byte_stream_serializer serializer;
+    EXPECT_TRUE(serializer.running_status_enabled());
+    EXPECT_FALSE(serializer.note_off_as_note_on_enabled());
+    EXPECT_FALSE(serializer.realtime_first_enabled());
+
+    std::vector<std::uint8_t> bytes(std::size(packets) * midi1_byte_stream_serializer::max_bytes_per_packet);
+    bytes.resize(serializer.serialize(packets, std::size(packets), bytes.data()));
+    EXPECT_EQ(expected, bytes);
+
+    // the resulting stream parses to the same packets
+    std::vector<universal_packet> parsed;
+    midi1_byte_stream_parser      parser([&](universal_packet p) { parsed.push_back(p); });
+    parser.feed(bytes.data(), bytes.size());
+    EXPECT_EQ(std::vector<universal_packet>(std::begin(packets), std::end(packets) - 1), parsed);
+
+    // running status is kept across blocks until reset
+    std::uint8_t result[midi1_byte_stream_serializer::max_bytes_per_packet];
+    EXPECT_EQ(1u, serializer.serialize(packets[10], result));
+    serializer.reset();
+    EXPECT_EQ(2u, serializer.serialize(packets[10], result));
+
+    // without running status
+    midi1_byte_stream_serializer plain{ false };
+    EXPECT_FALSE(plain.running_status_enabled());
+    bytes.resize(std::size(packets) * midi1_byte_stream_serializer::max_bytes_per_packet);
+    bytes.resize(plain.serialize(packets, std::size(packets), bytes.data()));
+
+    std::vector<std::uint8_t> one_by_one;
+    for (const auto& p : packets)
+    {
+        std::uint8_t b[8];
+        one_by_one.insert(one_by_one.end(), b, b + to_midi1_byte_stream(p, b));
+    }
+    EXPECT_EQ(one_by_one, bytes);
+}
+
+//-----------------------------------------------
+
+TEST_F(midi1_byte_stream, serializer_note_off_as_note_on)
+{
+    using namespace midi;
+
+    const universal_packet packets[] = {
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::note_on, 2, 0x3C, 0x40),
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::note_off, 2, 0x3C, 0x40),
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::note_on, 2, 0x3E, 0x40),
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::note_off, 2, 0x3E, 0x10),
+    };
+
+    midi1_byte_stream_serializer serializer;
+    serializer.enable_note_off_as_note_on(true);
+    EXPECT_TRUE(serializer.note_off_as_note_on_enabled());
+
+    std::uint8_t bytes[std::size(packets) * midi1_byte_stream_serializer::max_bytes_per_packet];
+    const auto   num_bytes = serializer.serialize(packets, std::size(packets), bytes);
+
+    const std::vector<std::uint8_t> expected = { 0x92, 0x3C, 0x40, 0x3C, 0x00, 0x3E, 0x40, 0x3E, 0x00 };
+    EXPECT_EQ(expected, std::vector<std::uint8_t>(bytes, bytes + num_bytes));
+}
+
+//-----------------------------------------------
+
+TEST_F(midi1_byte_stream, serializer_realtime_first)
+{
+    using namespace midi;
+
+    const universal_packet packets[] = {
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::note_on, 0, 0x3C, 0x40),
+        { 0x30167D01, 0x02030405 },
+        make_system_message(0, system_status::clock),
+        { 0x30320607, 0x00000000 },
+        make_system_message(0, system_status::clock),
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::note_on, 0, 0x3E, 0x40),
+    };
+
+    midi1_byte_stream_serializer serializer;
+    serializer.enable_realtime_first(true);
+    EXPECT_TRUE(serializer.realtime_first_enabled());
+
+    std::uint8_t bytes[std::size(packets) * midi1_byte_stream_serializer::max_bytes_per_packet];
+    const auto   num_bytes = serializer.serialize(packets, std::size(packets), bytes);
+
+    const std::vector<std::uint8_t> expected = { 0xF8, 0xF8, 0x90, 0x3C, 0x40, 0xF0, 0x7D, 0x01, 0x02, 0x03,
+                                                 0x04, 0x05, 0x06, 0x07, 0xF7, 0x90, 0x3E, 0x40 };
+    EXPECT_EQ(expected, std::vector<std::uint8_t>(bytes, bytes + num_bytes));
+}
+
+//-----------------------------------------------
+
 TEST_F(midi1_byte_stream, size_utility_messages)
 {
     for (std::uint32_t d = 0x0000; d < 0x0100; ++d)
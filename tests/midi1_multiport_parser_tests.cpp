@@ -0,0 +1,172 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/midi1_multiport_parser.h>
+
+#include <midi/midi1_byte_stream.h>
+#include <midi/midi1_channel_voice_message.h>
+#include <midi/system_message.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+//-----------------------------------------------
+
+class midi1_multiport_parser : public ::testing::Test
+{
+  public:
+    static std::vector<std::uint8_t> make_byte_stream(unsigned seed)
+    {
+        std::mt19937 rng{ seed };
+
+        std::vector<std::uint8_t> result;
+        for (auto i = 0u; i < 2000; ++i)
+        {
+            const auto r = rng() % 100;
+            if (r < 60)
+                result.push_back(std::uint8_t(rng() & 0x7F)); // data byte
+            else if (r < 80)
+                result.push_back(std::uint8_t(0x80 + (rng() % 0x70))); // channel voice status
+            else if (r < 85)
+                result.push_back(0xF0);
+            else if (r < 90)
+                result.push_back(0xF7);
+            else
+                result.push_back(std::uint8_t(0xF1 + (rng() % 15))); // system common / realtime
+        }
+        return result;
+    }
+};
+
+//-----------------------------------------------
+
+TEST_F(midi1_multiport_parser, port_groups)
+{
+    midi::basic_midi1_multiport_parser<std::function<void(midi::universal_packet)>, 20> p{ nullptr };
+
+    EXPECT_EQ(20u, p.num_ports);
+    EXPECT_EQ(0u, p.port_group(0));
+    EXPECT_EQ(15u, p.port_group(15));
+    EXPECT_EQ(0u, p.port_group(16));
+    EXPECT_EQ(3u, p.port_group(19));
+
+    p.set_port_group(19, 9);
+    EXPECT_EQ(9u, p.port_group(19));
+
+    p.reset();
+    EXPECT_EQ(9u, p.port_group(19));
+}
+
+//-----------------------------------------------
+
+TEST_F(midi1_multiport_parser, interleaved_ports)
+{
+    using namespace midi;
+
+    std::vector<universal_packet> packets;
+    midi::midi1_multiport_parser  p{ [&](universal_packet packet) { packets.push_back(packet); } };
+    p.set_port_group(2, 7);
+
+    constexpr std::uint8_t port0a[] = { 0x90, 0x3C };
+    constexpr std::uint8_t port2a[] = { 0xB1, 0x07, 0x10, 0x0A };
+    constexpr std::uint8_t port0b[] = { 0x40, 0x3E, 0xF8, 0x40 };
+    constexpr std::uint8_t port2b[] = { 0x20, 0xF0, 0x7D, 0x01, 0xF7 };
+
+    p.feed(0, port0a, sizeof(port0a));
+    p.feed(2, port2a, sizeof(port2a));
+    p.feed(0, port0b, sizeof(port0b));
+    p.feed(2, port2b, sizeof(port2b));
+
+    const universal_packet expected[] = {
+        make_midi1_channel_voice_message(7, midi1_channel_voice_status::control_change, 1, 0x07, 0x10),
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::note_on, 0, 0x3C, 0x40),
+        make_system_message(0, system_status::clock),
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::note_on, 0, 0x3E, 0x40),
+        make_midi1_channel_voice_message(7, midi1_channel_voice_status::control_change, 1, 0x0A, 0x20),
+        { 0x37027D01, 0x00000000 },
+    };
+
+    EXPECT_EQ(std::vector<universal_packet>(std::begin(expected), std::end(expected)), packets);
+}
+
+//-----------------------------------------------
+
+TEST_F(midi1_multiport_parser, matches_single_port_parsers)
+{
+    constexpr size_t num_ports = 4;
+
+    std::vector<std::uint8_t> streams[num_ports];
+    for (auto port = 0u; port < num_ports; ++port)
+        streams[port] = make_byte_stream(port + 1);
+
+    // reference
+    std::vector<midi::universal_packet> expected;
+    for (auto port = 0u; port < num_ports; ++port)
+    {
+        midi::midi1_byte_stream_parser ref(midi::group_t(port),
+                                           [&](midi::universal_packet packet) { expected.push_back(packet); });
+        ref.feed(streams[port].data(), streams[port].size());
+    }
+    ASSERT_FALSE(expected.empty());
+
+    // interleaved chunks of varying size
+    std::vector<midi::universal_packet> packets;
+    midi::midi1_multiport_parser        p{ [&](midi::universal_packet packet) { packets.push_back(packet); } };
+
+    std::mt19937 rng{ 42 };
+    size_t       pos[num_ports] = {};
+    for (bool done = false; !done;)
+    {
+        done = true;
+        for (auto port = 0u; port < num_ports; ++port)
+        {
+            const auto n = std::min(size_t(rng() % 9), streams[port].size() - pos[port]);
+            if (n == 1)
+                p.feed(port, streams[port][pos[port]]);
+            else
+                p.feed(port, streams[port].data() + pos[port], n);
+            pos[port] += n;
+            done = done && (pos[port] == streams[port].size());
+        }
+    }
+
+    // compare the packets of each group in order
+    for (auto port = 0u; port < num_ports; ++port)
+    {
+        std::vector<midi::universal_packet> expected_port, port_packets;
+        for (const auto& packet : expected)
+            if (packet.group() == port)
+                expected_port.push_back(packet);
+        for (const auto& packet : packets)
+            if (packet.group() == port)
+                port_packets.push_back(packet);
+
+        EXPECT_FALSE(expected_port.empty());
+        EXPECT_EQ(expected_port, port_packets);
+    }
+    EXPECT_EQ(expected.size(), packets.size());
+}
+
+//-----------------------------------------------
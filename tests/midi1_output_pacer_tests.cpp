@@ -0,0 +1,289 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/midi1_output_pacer.h>
+
+#include <midi/midi1_channel_voice_message.h>
+#include <midi/system_message.h>
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+//-----------------------------------------------
+
+class midi1_output_pacer : public ::testing::Test
+{
+  public:
+    using sent_packets = std::vector<std::pair<midi::universal_packet, std::uint64_t>>;
+
+    static size_t poll(midi::midi1_output_pacer& pacer, std::uint64_t now, sent_packets& sent)
+    {
+        return pacer.poll(now, [&](const midi::universal_packet& p, std::uint64_t t) { sent.emplace_back(p, t); });
+    }
+};
+
+//-----------------------------------------------
+
+TEST_F(midi1_output_pacer, wire_size_and_priority)
+{
+    using namespace midi;
+    using pacer = midi::midi1_output_pacer;
+
+    const auto note_on = make_midi1_channel_voice_message(0, midi1_channel_voice_status::note_on, 0, 0x3C, 0x40);
+    const auto program = make_midi1_channel_voice_message(0, midi1_channel_voice_status::program_change, 0, 1, 0);
+    const auto clock   = make_system_message(0, system_status::clock);
+    const auto song    = make_system_message(0, system_status::song_select, 0x05);
+
+    EXPECT_EQ(3u, pacer::wire_size(note_on));
+    EXPECT_EQ(2u, pacer::wire_size(program));
+    EXPECT_EQ(1u, pacer::wire_size(clock));
+    EXPECT_EQ(2u, pacer::wire_size(song));
+    EXPECT_EQ(5u, pacer::wire_size(universal_packet{ 0x30037D01, 0x02000000 }));
+    EXPECT_EQ(7u, pacer::wire_size(universal_packet{ 0x30167D01, 0x02030405 }));
+    EXPECT_EQ(6u, pacer::wire_size(universal_packet{ 0x30260102, 0x03040506 }));
+    EXPECT_EQ(3u, pacer::wire_size(universal_packet{ 0x30320102, 0x00000000 }));
+    EXPECT_EQ(0u, pacer::wire_size(universal_packet{ 0x40903C00, 0xFFFF0000 }));
+
+    EXPECT_EQ(pacer::priority::note, pacer::packet_priority(note_on));
+    EXPECT_EQ(pacer::priority::controller, pacer::packet_priority(program));
+    EXPECT_EQ(pacer::priority::realtime, pacer::packet_priority(clock));
+    EXPECT_EQ(pacer::priority::sysex, pacer::packet_priority(song));
+    EXPECT_EQ(pacer::priority::sysex, pacer::packet_priority(universal_packet{ 0x30037D01, 0x02000000 }));
+
+    EXPECT_TRUE(requires_midi1_pacing(function_block_options{ true,
+                                                              function_block_options::bidirectional,
+                                                              function_block_options::midi1_31250 }));
+    EXPECT_FALSE(requires_midi1_pacing(function_block_options{}));
+}
+
+//-----------------------------------------------
+
+TEST_F(midi1_output_pacer, pacing)
+{
+    using namespace midi;
+
+    midi::midi1_output_pacer pacer;
+    EXPECT_TRUE(pacer.empty());
+    EXPECT_EQ(std::numeric_limits<std::uint64_t>::max(), pacer.next_send_time());
+
+    for (uint7_t note = 60; note < 63; ++note)
+        EXPECT_TRUE(pacer.push(make_midi1_channel_voice_message(0, midi1_channel_voice_status::note_on, 0, note, 0x40),
+                               1000));
+    EXPECT_EQ(3u, pacer.size());
+    EXPECT_EQ(1000u, pacer.next_send_time());
+
+    sent_packets sent;
+    EXPECT_EQ(0u, poll(pacer, 999, sent));
+    EXPECT_EQ(1u, poll(pacer, 1000, sent));
+    EXPECT_EQ(1960u, pacer.wire_free_time());
+    EXPECT_EQ(1960u, pacer.next_send_time());
+    EXPECT_EQ(0u, poll(pacer, 1959, sent));
+    EXPECT_EQ(1u, poll(pacer, 1960, sent));
+    EXPECT_EQ(1u, poll(pacer, 10000, sent));
+    EXPECT_TRUE(pacer.empty());
+
+    ASSERT_EQ(3u, sent.size());
+    EXPECT_EQ(1000u, sent[0].second);
+    EXPECT_EQ(1960u, sent[1].second);
+    EXPECT_EQ(2920u, sent[2].second);
+    EXPECT_EQ(62u, sent[2].first.get_byte(2));
+
+    // idle wire, packet is sent at its timestamp
+    EXPECT_TRUE(pacer.push(make_system_message(0, system_status::start), 20000));
+    EXPECT_EQ(1u, poll(pacer, 30000, sent));
+    EXPECT_EQ(20000u, sent.back().second);
+    EXPECT_EQ(20320u, pacer.wire_free_time());
+}
+
+//-----------------------------------------------
+
+TEST_F(midi1_output_pacer, priorities)
+{
+    using namespace midi;
+
+    const universal_packet sysex{ 0x30037D01, 0x02000000 };
+    const auto cc    = make_midi1_channel_voice_message(0, midi1_channel_voice_status::control_change, 0, 7, 100);
+    const auto note  = make_midi1_channel_voice_message(0, midi1_channel_voice_status::note_on, 0, 0x3C, 0x40);
+    const auto clock = make_system_message(0, system_status::clock);
+
+    midi::midi1_output_pacer pacer;
+    EXPECT_TRUE(pacer.push(sysex, 0));
+    EXPECT_TRUE(pacer.push(cc, 0));
+    EXPECT_TRUE(pacer.push(note, 0));
+    EXPECT_TRUE(pacer.push(clock, 0));
+
+    sent_packets sent;
+    EXPECT_EQ(1u, poll(pacer, 0, sent));
+    EXPECT_EQ(3u, poll(pacer, 100000, sent));
+
+    const sent_packets expected = { { clock, 0 }, { note, 320 }, { cc, 1280 }, { sysex, 2240 } };
+    EXPECT_EQ(expected, sent);
+}
+
+//-----------------------------------------------
+
+TEST_F(midi1_output_pacer, capacity)
+{
+    using namespace midi;
+
+    midi::midi1_output_pacer pacer{ 2 };
+    EXPECT_EQ(2u, pacer.capacity());
+
+    const auto clock = make_system_message(0, system_status::clock);
+    EXPECT_TRUE(pacer.push(clock, 0));
+    EXPECT_TRUE(pacer.push(clock, 0));
+    EXPECT_FALSE(pacer.push(clock, 0));
+
+    pacer.clear();
+    EXPECT_TRUE(pacer.empty());
+    EXPECT_TRUE(pacer.push(clock, 0));
+}
+
+//-----------------------------------------------
+
+TEST_F(midi1_output_pacer, controller_thinning)
+{
+    using namespace midi;
+
+    const auto cc = [](channel_t channel, uint7_t controller, uint7_t value) {
+        return make_midi1_channel_voice_message(
+          0, midi1_channel_voice_status::control_change, channel, controller, value);
+    };
+    const auto pitch_bend = [](uint7_t msb) {
+        return make_midi1_channel_voice_message(0, midi1_channel_voice_status::pitch_bend, 0, 0, msb);
+    };
+
+    for (const bool thinning : { false, true })
+    {
+        midi::midi1_output_pacer pacer{ 4 };
+        pacer.enable_controller_thinning(thinning);
+        EXPECT_EQ(thinning, pacer.controller_thinning_enabled());
+
+        const universal_packet packets[] = { cc(0, 7, 1),      cc(0, 7, 2),      cc(0, 10, 3), cc(1, 7, 4),
+                                             pitch_bend(0x10), pitch_bend(0x20), cc(0, 7, 5),  pitch_bend(0x30) };
+
+        size_t num_accepted = 0;
+        for (const auto& p : packets)
+            num_accepted += pacer.push(p, 0) ? 1 : 0;
+
+        sent_packets sent;
+        poll(pacer, 100000, sent);
+
+        if (thinning)
+        {
+            EXPECT_EQ(std::size(packets), num_accepted);
+
+            const sent_packets expected = {
+                { cc(0, 7, 5), 0 }, { cc(0, 10, 3), 960 }, { cc(1, 7, 4), 1920 }, { pitch_bend(0x30), 2880 }
+            };
+            EXPECT_EQ(expected, sent);
+        }
+        else
+        {
+            EXPECT_EQ(4u, num_accepted);
+            EXPECT_EQ(4u, sent.size());
+        }
+    }
+}
+
+//-----------------------------------------------
+
+TEST_F(midi1_output_pacer, controller_thinning_only_when_held_back)
+{
+    using namespace midi;
+
+    const auto cc = [](uint7_t value) {
+        return make_midi1_channel_voice_message(0, midi1_channel_voice_status::control_change, 0, 7, value);
+    };
+    const auto program = [](uint7_t value) {
+        return make_midi1_channel_voice_message(0, midi1_channel_voice_status::program_change, 0, value, 0);
+    };
+
+    midi::midi1_output_pacer pacer;
+    pacer.enable_controller_thinning(true);
+
+    sent_packets sent;
+    poll(pacer, 1000, sent);
+
+    // future values on an idle wire are all sent
+    EXPECT_TRUE(pacer.push(cc(1), 5000));
+    EXPECT_TRUE(pacer.push(cc(2), 6000));
+    EXPECT_EQ(2u, pacer.size());
+
+    poll(pacer, 10000, sent);
+    const sent_packets expected = { { cc(1), 5000 }, { cc(2), 6000 } };
+    EXPECT_EQ(expected, sent);
+
+    // a value held back by a busy wire is replaced, keeping its due time
+    sent.clear();
+    EXPECT_TRUE(pacer.push(program(1), 20000));
+    EXPECT_TRUE(pacer.push(program(2), 20000));
+    EXPECT_TRUE(pacer.push(cc(3), 20000));
+    poll(pacer, 20000, sent);
+    EXPECT_EQ(1u, sent.size());
+    EXPECT_TRUE(pacer.push(cc(4), 20100));
+    EXPECT_EQ(2u, pacer.size()) << "program changes are not replaced";
+
+    poll(pacer, 30000, sent);
+    const sent_packets expected_busy = { { program(1), 20000 }, { program(2), 20640 }, { cc(4), 21280 } };
+    EXPECT_EQ(expected_busy, sent);
+}
+
+//-----------------------------------------------
+
+TEST_F(midi1_output_pacer, controller_thinning_keeps_due_time)
+{
+    using namespace midi;
+
+    const auto cc = [](controller_t controller, uint7_t value) {
+        return make_midi1_channel_voice_message(0, midi1_channel_voice_status::control_change, 0, controller, value);
+    };
+
+    midi::midi1_output_pacer pacer;
+    pacer.enable_controller_thinning(true);
+
+    sent_packets sent;
+    EXPECT_TRUE(pacer.push(cc(7, 1), 1000));
+    EXPECT_TRUE(pacer.push(cc(10, 1), 1100));
+    EXPECT_TRUE(pacer.push(cc(11, 1), 1100));
+    poll(pacer, 1000, sent);
+
+    // held back by the busy wire, replaced by values scheduled later
+    EXPECT_TRUE(pacer.push(cc(10, 2), 1200));
+    poll(pacer, 1100, sent);
+    EXPECT_TRUE(pacer.push(cc(10, 3), 50000));
+    EXPECT_EQ(2u, pacer.size());
+
+    // the replaced value does not block the due value behind it
+    poll(pacer, 5000, sent);
+    EXPECT_EQ(0u, pacer.size());
+
+    const sent_packets expected = { { cc(7, 1), 1000 }, { cc(10, 3), 1960 }, { cc(11, 1), 2920 } };
+    EXPECT_EQ(expected, sent);
+}
+
+//-----------------------------------------------
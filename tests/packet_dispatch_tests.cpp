@@ -0,0 +1,119 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/packet_dispatch.h>
+
+#include <midi/jitter_reduction_timestamps.h>
+
+#include <string>
+#include <vector>
+
+//-----------------------------------------------
+
+class packet_dispatch : public ::testing::Test
+{
+  public:
+    struct recorder
+    {
+        std::vector<std::string> calls;
+
+        void operator()(midi::utility_message_view) { calls.push_back("utility"); }
+        void operator()(midi::system_message_view) { calls.push_back("system"); }
+        void operator()(midi::midi1_channel_voice_message_view) { calls.push_back("midi1"); }
+        void operator()(midi::midi2_channel_voice_message_view) { calls.push_back("midi2"); }
+        void operator()(midi::sysex7_packet_view) { calls.push_back("sysex7"); }
+        void operator()(midi::sysex8_packet_view) { calls.push_back("sysex8"); }
+        void operator()(midi::flex_data_message_view) { calls.push_back("flex"); }
+        void operator()(midi::stream_configuration_view v)
+        {
+            calls.push_back("stream_configuration " + std::to_string(v.protocol()));
+        }
+        void operator()(midi::function_block_info_view) { calls.push_back("function_block_info"); }
+        void operator()(const midi::universal_packet&) { calls.push_back("other"); }
+    };
+};
+
+//-----------------------------------------------
+
+TEST_F(packet_dispatch, all_types)
+{
+    using namespace midi;
+
+    const universal_packet packets[] = {
+        jr_timestamp_message{ jr_timestamp_t{ 100 } },
+        make_system_message(0, system_status::clock),
+        universal_packet{ 0x20903C40 },
+        universal_packet{ 0x30160102, 0x03040506 },
+        universal_packet{ 0x40903C00, 0x80000000 },
+        universal_packet{ 0x5001001F, 0, 0, 0 },
+        universal_packet{ 0xD0100001, 0, 0, 0 },
+        make_stream_configuration_request(protocol::midi2),
+        universal_packet{ 0xF0110000, 0, 0, 0 },
+        make_endpoint_name_message(packet_format::complete, "test"),
+        universal_packet{ 0x60000000 },
+        universal_packet{ 0x30700000, 0 },
+        universal_packet{ 0xF3FF0000, 0, 0, 0 },
+    };
+
+    recorder r;
+    dispatch(packets, sizeof(packets) / sizeof(packets[0]), r);
+
+    EXPECT_EQ((std::vector<std::string>{ "utility",
+                                         "system",
+                                         "midi1",
+                                         "sysex7",
+                                         "midi2",
+                                         "sysex8",
+                                         "flex",
+                                         "stream_configuration 2",
+                                         "function_block_info",
+                                         "other",
+                                         "other",
+                                         "other",
+                                         "other" }),
+              r.calls);
+}
+
+//-----------------------------------------------
+
+TEST_F(packet_dispatch, partial_handler)
+{
+    using namespace midi;
+
+    int num_midi2 = 0;
+    dispatch(universal_packet{ 0x40903C00, 0x80000000 }, [&](midi2_channel_voice_message_view v) {
+        EXPECT_EQ(channel_voice_status::note_on, v.status());
+        ++num_midi2;
+    });
+    dispatch(universal_packet{ 0x20903C40 }, [&](midi2_channel_voice_message_view) { ++num_midi2; });
+    EXPECT_EQ(1, num_midi2);
+
+    // generic handler receives every view type
+    int num_calls = 0;
+    dispatch(universal_packet{ 0x20903C40 }, [&](auto) { ++num_calls; });
+    dispatch(make_stream_configuration_request(protocol::midi1), [&](auto) { ++num_calls; });
+    EXPECT_EQ(2, num_calls);
+}
+
+//-----------------------------------------------
@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/packet_filter.h>
+
+#include <midi/midi1_channel_voice_message.h>
+#include <midi/midi2_channel_voice_message.h>
+#include <midi/system_message.h>
+
+#include <vector>
+
+//-----------------------------------------------
+
+class packet_filter : public ::testing::Test
+{
+  public:
+};
+
+//-----------------------------------------------
+
+TEST_F(packet_filter, default_rejects_all)
+{
+    using namespace midi;
+
+    midi::packet_filter f;
+    EXPECT_FALSE(f.accepts(universal_packet{ 0x20903C40 }));
+    EXPECT_FALSE(f.accepts(universal_packet{ 0x10F80000 }));
+
+    f.accept_all();
+    EXPECT_TRUE(f.accepts(universal_packet{ 0x20903C40 }));
+    EXPECT_TRUE(f.accepts(universal_packet{ 0x10F80000 }));
+
+    f.reject_all();
+    EXPECT_FALSE(f.accepts(universal_packet{ 0x20903C40 }));
+}
+
+//-----------------------------------------------
+
+TEST_F(packet_filter, rules)
+{
+    using namespace midi;
+
+    midi::packet_filter f;
+    f.accept(packet_type::midi2_channel_voice,
+             midi::packet_filter::group_mask(1),
+             midi::packet_filter::status_mask(channel_voice_status::note_on) |
+               midi::packet_filter::status_mask(channel_voice_status::note_off),
+             midi::packet_filter::channel_mask(3));
+    f.accept(packet_type::midi1_channel_voice, midi::packet_filter::group_mask(2));
+    f.accept(packet_type::system).reject(packet_type::system, midi::packet_filter::all, 0x8000, 0x0100); // no clock
+
+    const auto note_on = make_midi2_note_on_message(1, 3, note_nr_t{ 60 }, velocity{ uint16_t{ 0x8000 } });
+    EXPECT_TRUE(f.accepts(note_on));
+    EXPECT_TRUE(f.accepts(make_midi2_note_off_message(1, 3, note_nr_t{ 60 }, velocity{ uint16_t{ 0 } })));
+    EXPECT_FALSE(f.accepts(make_midi2_note_on_message(1, 4, note_nr_t{ 60 }, velocity{ uint16_t{ 0x8000 } })));
+    EXPECT_FALSE(f.accepts(make_midi2_note_on_message(0, 3, note_nr_t{ 60 }, velocity{ uint16_t{ 0x8000 } })));
+    EXPECT_FALSE(f.accepts(make_midi2_control_change_message(1, 3, 7, controller_value{ uint32_t{ 0 } })));
+
+    EXPECT_TRUE(f.accepts(make_midi1_control_change_message(2, 9, 7, controller_value{ uint7_t{ 100 } })));
+    EXPECT_FALSE(f.accepts(make_midi1_control_change_message(3, 9, 7, controller_value{ uint7_t{ 100 } })));
+
+    EXPECT_TRUE(f.accepts(make_system_message(5, system_status::start)));
+    EXPECT_FALSE(f.accepts(make_system_message(5, system_status::clock)));
+
+    EXPECT_FALSE(f.accepts(universal_packet{ 0x30160102, 0x03040506 }));
+}
+
+//-----------------------------------------------
+
+TEST_F(packet_filter, apply_packets)
+{
+    using namespace midi;
+
+    midi::packet_filter f;
+    f.accept(packet_type::midi1_channel_voice, midi::packet_filter::all, midi::packet_filter::all, 0x0001);
+
+    std::vector<universal_packet> packets = { universal_packet{ 0x20903C40 },
+                                              universal_packet{ 0x10F80000 },
+                                              universal_packet{ 0x20913C40 },
+                                              universal_packet{ 0x21803C40 },
+                                              universal_packet{ 0x40903C00, 0x80000000 } };
+
+    std::vector<universal_packet> out(packets.size());
+    ASSERT_EQ(2u, f.apply(packets.data(), packets.size(), out.data()));
+    EXPECT_EQ(packets[0], out[0]);
+    EXPECT_EQ(packets[3], out[1]);
+
+    // in place
+    ASSERT_EQ(2u, f.apply(packets.data(), packets.size(), packets.data()));
+    EXPECT_EQ(universal_packet{ 0x21803C40 }, packets[1]);
+}
+
+//-----------------------------------------------
+
+TEST_F(packet_filter, apply_words)
+{
+    using namespace midi;
+
+    midi::packet_filter f;
+    f.accept(packet_type::midi2_channel_voice).accept(packet_type::stream);
+
+    std::vector<uint32_t> words = { 0x20903C40, 0x40903C00, 0x80000000, 0x10F80000,
+                                    0xF0050200, 0,          0,          0,
+                                    0x20803C40, 0x41803C00, 0x00000000, 0x40903C00 };
+
+    std::vector<uint32_t> out(words.size());
+    ASSERT_EQ(8u, f.apply(words.data(), words.size(), out.data()));
+    EXPECT_EQ((std::vector<uint32_t>{ 0x40903C00, 0x80000000, 0xF0050200, 0, 0, 0, 0x41803C00, 0x00000000 }),
+              std::vector<uint32_t>(out.begin(), out.begin() + 8));
+
+    ASSERT_EQ(8u, f.apply(words.data(), words.size(), words.data()));
+    words.resize(8);
+    out.resize(8);
+    EXPECT_EQ(out, words);
+}
+
+//-----------------------------------------------
@@ -0,0 +1,122 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/packet_remapper.h>
+
+#include <midi/flex_data_message.h>
+#include <midi/stream_message.h>
+
+#include <vector>
+
+//-----------------------------------------------
+
+class packet_remapper : public ::testing::Test
+{
+  public:
+};
+
+//-----------------------------------------------
+
+TEST_F(packet_remapper, identity)
+{
+    using namespace midi;
+
+    midi::packet_remapper r;
+    for (uint32_t t = 0; t < 16; ++t)
+    {
+        const uint32_t w = (t << 28) | 0x0A9B3C4D;
+        EXPECT_EQ(w, r.remap(w));
+    }
+}
+
+//-----------------------------------------------
+
+TEST_F(packet_remapper, groups_and_channels)
+{
+    using namespace midi;
+
+    midi::packet_remapper r;
+    r.map_group(1, 5);
+    r.map_channel(2, 3, 7, 9);
+
+    EXPECT_EQ(5u, r.group_for(1));
+    EXPECT_EQ(5u, r.group_for(1, 4));
+    EXPECT_EQ(4u, r.channel_for(1, 4));
+    EXPECT_EQ(2u, r.group_for(2));
+    EXPECT_EQ(7u, r.group_for(2, 3));
+    EXPECT_EQ(9u, r.channel_for(2, 3));
+
+    // MIDI 1 / MIDI 2 channel voice
+    EXPECT_EQ(0x25943C40u, r.remap(0x21943C40));
+    EXPECT_EQ(0x47993C00u, r.remap(0x42933C00));
+    EXPECT_EQ(0x42943C00u, r.remap(0x42943C00));
+
+    // system and data messages only change group
+    EXPECT_EQ(0x15F80000u, r.remap(0x11F80000));
+    EXPECT_EQ(0x12F30000u, r.remap(0x12F30000));
+    EXPECT_EQ(0x35160102u, r.remap(0x31160102));
+    EXPECT_EQ(0x55010000u, r.remap(0x51010000));
+
+    // flex data channel
+    EXPECT_EQ(0xD7090001u, r.remap(0xD2030001));
+
+    // flex data group, only the group map applies
+    EXPECT_EQ(0xD5100000u, r.remap(0xD1100000));
+    EXPECT_EQ(0xD2130001u, r.remap(0xD2130001));
+    EXPECT_EQ(0xD5530102u, r.remap(0xD1530102));
+
+    // groupless messages are untouched
+    EXPECT_EQ(0x01200064u, r.remap(0x01200064));
+    EXPECT_EQ(0xF1030000u, r.remap(0xF1030000));
+
+    r.reset();
+    EXPECT_EQ(0x21943C40u, r.remap(0x21943C40));
+}
+
+//-----------------------------------------------
+
+TEST_F(packet_remapper, buffers)
+{
+    using namespace midi;
+
+    midi::packet_remapper r;
+    r.map_group(0, 3);
+    r.map_channel(0, 0, 0, 1);
+
+    universal_packet packets[] = { universal_packet{ 0x20903C40 },
+                                   universal_packet{ 0x20913C40 },
+                                   make_stream_configuration_request(protocol::midi2) };
+    r.apply(packets, 3);
+    EXPECT_EQ(0x20913C40u, packets[0].data[0]);
+    EXPECT_EQ(0x23913C40u, packets[1].data[0]);
+    EXPECT_EQ(make_stream_configuration_request(protocol::midi2), packets[2]);
+
+    std::vector<uint32_t> words = { 0x40903C00, 0x80000000, 0x10F80000, 0xF0050200, 0, 0, 0, 0x20903C40, 0x40913C00 };
+    EXPECT_EQ(8u, r.apply(words.data(), words.size()));
+    EXPECT_EQ(
+      (std::vector<uint32_t>{ 0x40913C00, 0x80000000, 0x13F80000, 0xF0050200, 0, 0, 0, 0x20913C40, 0x40913C00 }),
+      words);
+}
+
+//-----------------------------------------------
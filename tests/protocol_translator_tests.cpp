@@ -0,0 +1,470 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/protocol_translator.h>
+
+#include <midi/channel_voice_message.h>
+#include <midi/midi1_channel_voice_message.h>
+#include <midi/midi2_channel_voice_message.h>
+#include <midi/system_message.h>
+
+#include <iterator>
+#include <random>
+#include <vector>
+
+//-----------------------------------------------
+
+class protocol_translator : public ::testing::Test
+{
+  public:
+    template<typename Translator>
+    static std::vector<midi::universal_packet> translate(Translator& t, const midi::universal_packet& p)
+    {
+        std::vector<midi::universal_packet> result;
+        t.translate(p, [&](const midi::universal_packet& out) { result.push_back(out); });
+        return result;
+    }
+
+    static midi::universal_packet cc(midi::group_t g, midi::channel_t c, midi::controller_t nr, midi::uint7_t v)
+    {
+        return midi::make_midi1_control_change_message(g, c, nr, midi::controller_value{ v });
+    }
+};
+
+//-----------------------------------------------
+
+TEST_F(protocol_translator, midi2_to_midi1_pass_through)
+{
+    using namespace midi;
+
+    midi2_to_midi1_translator t;
+
+    const universal_packet packets[] = {
+        make_system_message(1, system_status::clock),
+        make_midi1_note_on_message(2, 3, 60, velocity{ uint7_t{ 100 } }),
+        universal_packet{ 0x30037D01, 0x02000000 },
+    };
+
+    for (const auto& p : packets)
+        EXPECT_EQ(std::vector<universal_packet>{ p }, translate(t, p));
+}
+
+//-----------------------------------------------
+
+TEST_F(protocol_translator, midi2_to_midi1_channel_voice_messages)
+{
+    using namespace midi;
+
+    midi2_to_midi1_translator t;
+
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi1_note_on_message(1, 2, 60, velocity{ uint7_t{ 100 } }) },
+              translate(t, make_midi2_note_on_message(1, 2, 60, velocity{ uint7_t{ 100 } })));
+
+    // attributes are dropped
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi1_note_on_message(1, 2, 60, velocity{ uint7_t{ 100 } }) },
+              translate(t,
+                        make_midi2_note_on_message(1, 2, 60, velocity{ uint7_t{ 100 } }, pitch_7_9{ 60.5f })));
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi1_note_off_message(1, 2, 60, velocity{ uint7_t{ 10 } }) },
+              translate(t, make_midi2_note_off_message(1, 2, 60, velocity{ uint7_t{ 10 } }, 0x3, 0x1234)));
+
+    // velocity 0 note on is sent with velocity 1
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi1_note_on_message(1, 2, 60, velocity{ uint7_t{ 1 } }) },
+              translate(t, make_midi2_note_on_message(1, 2, 60, velocity{ uint16_t{ 0 } })));
+
+    const auto volume = controller_value{ uint7_t{ 100 } };
+    EXPECT_EQ(std::vector<universal_packet>{ cc(0, 0, control_change::volume, 100) },
+              translate(t, make_midi2_control_change_message(0, 0, control_change::volume, volume)));
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi1_pitch_bend_message(4, 5, pitch_bend{ uint14_t{ 0x1234 } }) },
+              translate(t, make_midi2_pitch_bend_message(4, 5, pitch_bend{ uint14_t{ 0x1234 } })));
+
+    // no MIDI 1 equivalent
+    EXPECT_TRUE(
+      translate(t, make_midi2_control_change_message(0, 0, control_change::rpn_msb, controller_value{ uint7_t{ 1 } }))
+        .empty());
+    EXPECT_TRUE(translate(t, make_per_note_pitch_bend_message(0, 0, 60, pitch_bend{ uint14_t{ 0x1234 } })).empty());
+    EXPECT_TRUE(
+      translate(t, make_registered_per_note_controller_message(0, 0, 60, 1, controller_value{ uint7_t{ 1 } })).empty());
+}
+
+//-----------------------------------------------
+
+TEST_F(protocol_translator, midi2_to_midi1_program_change)
+{
+    using namespace midi;
+
+    midi2_to_midi1_translator t;
+
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi1_program_change_message(0, 3, 42) },
+              translate(t, make_midi2_program_change_message(0, 3, 42)));
+
+    const std::vector<universal_packet> with_bank = { cc(0, 3, control_change::bank_select_msb, 0x12),
+                                                      cc(0, 3, control_change::bank_select_lsb, 0x34),
+                                                      make_midi1_program_change_message(0, 3, 42) };
+    EXPECT_EQ(with_bank, translate(t, make_midi2_program_change_message(0, 3, 42, uint14_t((0x12 << 7) | 0x34))));
+}
+
+//-----------------------------------------------
+
+TEST_F(protocol_translator, midi2_to_midi1_registered_and_assignable_controllers)
+{
+    using namespace midi;
+
+    midi2_to_midi1_translator t;
+
+    const auto value = controller_value{ upsample_14_to_32bit(uint14_t((0x0C << 7) | 0x21)) };
+
+    // parameter number is only sent when it changes
+    const std::vector<universal_packet> rpn = { cc(2, 1, control_change::rpn_msb, 0),
+                                                cc(2, 1, control_change::rpn_lsb, 0),
+                                                cc(2, 1, control_change::data_entry_msb, 0x0C),
+                                                cc(2, 1, control_change::data_entry_lsb, 0x21) };
+    EXPECT_EQ(rpn, translate(t, make_registered_controller_message(2, 1, 0, 0, value)));
+    EXPECT_EQ(std::vector<universal_packet>(rpn.begin() + 2, rpn.end()),
+              translate(t, make_registered_controller_message(2, 1, 0, 0, value)));
+
+    // cached per channel
+    EXPECT_EQ(4u, translate(t, make_registered_controller_message(2, 2, 0, 0, value)).size());
+
+    const std::vector<universal_packet> nrpn = { cc(2, 1, control_change::nrpn_msb, 0x05),
+                                                 cc(2, 1, control_change::nrpn_lsb, 0x06),
+                                                 cc(2, 1, control_change::data_entry_msb, 0x0C),
+                                                 cc(2, 1, control_change::data_entry_lsb, 0x21) };
+    EXPECT_EQ(nrpn, translate(t, make_assignable_controller_message(2, 1, 0x05, 0x06, value)));
+    EXPECT_EQ(2u, translate(t, make_assignable_controller_message(2, 1, 0x05, 0x06, value)).size());
+
+    // MIDI 1 parameter selection invalidates the cache
+    EXPECT_EQ(1u, translate(t, cc(2, 1, control_change::nrpn_msb, 0x07)).size());
+    EXPECT_EQ(4u, translate(t, make_assignable_controller_message(2, 1, 0x05, 0x06, value)).size());
+
+    t.reset();
+    EXPECT_EQ(4u, translate(t, make_assignable_controller_message(2, 1, 0x05, 0x06, value)).size());
+}
+
+//-----------------------------------------------
+
+TEST_F(protocol_translator, midi2_to_midi1_bulk)
+{
+    using namespace midi;
+
+    const universal_packet packets[] = {
+        make_midi2_note_on_message(0, 0, 60, velocity{ uint7_t{ 100 } }),
+        make_registered_controller_message(0, 0, 0, 1, controller_value{ 0x80000000u }),
+        make_per_note_pitch_bend_message(0, 0, 60, pitch_bend{ uint14_t{ 0x1234 } }),
+        make_midi2_program_change_message(0, 0, 1, 2),
+    };
+
+    midi2_to_midi1_translator t;
+
+    universal_packet out[std::size(packets) * midi2_to_midi1_translator::max_packets_per_packet];
+    EXPECT_EQ(8u, t.translate(packets, std::size(packets), out));
+    EXPECT_EQ(make_midi1_program_change_message(0, 0, 1), out[7]);
+}
+
+//-----------------------------------------------
+
+TEST_F(protocol_translator, midi1_to_midi2_pass_through_and_channel_voice_messages)
+{
+    using namespace midi;
+
+    midi1_to_midi2_translator t;
+
+    const universal_packet packets[] = {
+        make_system_message(1, system_status::clock),
+        make_midi2_note_on_message(2, 3, 60, velocity{ uint7_t{ 100 } }),
+        universal_packet{ 0x30037D01, 0x02000000 },
+    };
+    for (const auto& p : packets)
+        EXPECT_EQ(std::vector<universal_packet>{ p }, translate(t, p));
+
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi2_note_on_message(1, 2, 60, velocity{ uint7_t{ 100 } }) },
+              translate(t, make_midi1_note_on_message(1, 2, 60, velocity{ uint7_t{ 100 } })));
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi2_program_change_message(1, 2, 5) },
+              translate(t, make_midi1_program_change_message(1, 2, 5)));
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi2_control_change_message(
+                1, 2, control_change::sustain, controller_value{ uint7_t{ 127 } }) },
+              translate(t, cc(1, 2, control_change::sustain, 127)));
+}
+
+//-----------------------------------------------
+
+TEST_F(protocol_translator, midi1_to_midi2_program_change_with_bank)
+{
+    using namespace midi;
+
+    midi1_to_midi2_translator t;
+
+    EXPECT_TRUE(translate(t, cc(0, 1, control_change::bank_select_msb, 0x12)).empty());
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi2_program_change_message(0, 1, 5, uint14_t(0x12 << 7)) },
+              translate(t, make_midi1_program_change_message(0, 1, 5)));
+
+    EXPECT_TRUE(translate(t, cc(0, 1, control_change::bank_select_lsb, 0x34)).empty());
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi2_program_change_message(0, 1, 6, uint14_t((0x12 << 7) | 0x34)) },
+              translate(t, make_midi1_program_change_message(0, 1, 6)));
+
+    // other channel has no bank
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi2_program_change_message(0, 2, 6) },
+              translate(t, make_midi1_program_change_message(0, 2, 6)));
+
+    t.reset();
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi2_program_change_message(0, 1, 6) },
+              translate(t, make_midi1_program_change_message(0, 1, 6)));
+}
+
+//-----------------------------------------------
+
+TEST_F(protocol_translator, midi1_to_midi2_registered_and_assignable_controllers)
+{
+    using namespace midi;
+
+    midi1_to_midi2_translator t;
+
+    // data entry without parameter
+    EXPECT_TRUE(translate(t, cc(3, 4, control_change::data_entry_msb, 0x0C)).empty());
+
+    EXPECT_TRUE(translate(t, cc(3, 4, control_change::rpn_msb, 0)).empty());
+    EXPECT_TRUE(translate(t, cc(3, 4, control_change::data_entry_msb, 0x0C)).empty()); // incomplete selection
+    EXPECT_TRUE(translate(t, cc(3, 4, control_change::rpn_lsb, 0)).empty());
+    EXPECT_TRUE(translate(t, cc(3, 4, control_change::data_entry_lsb, 0x21)).empty()); // LSB without MSB
+
+    EXPECT_EQ(std::vector<universal_packet>{ make_registered_controller_message(
+                3, 4, 0, 0, controller_value{ upsample_7_to_32bit(0x0C) }) },
+              translate(t, cc(3, 4, control_change::data_entry_msb, 0x0C)));
+    EXPECT_EQ(std::vector<universal_packet>{ make_registered_controller_message(
+                3, 4, 0, 0, controller_value{ upsample_14_to_32bit(uint14_t((0x0C << 7) | 0x21)) }) },
+              translate(t, cc(3, 4, control_change::data_entry_lsb, 0x21)));
+
+    // NRPN
+    EXPECT_TRUE(translate(t, cc(3, 4, control_change::nrpn_msb, 0x05)).empty());
+    EXPECT_TRUE(translate(t, cc(3, 4, control_change::nrpn_lsb, 0x06)).empty());
+    EXPECT_EQ(std::vector<universal_packet>{ make_assignable_controller_message(
+                3, 4, 0x05, 0x06, controller_value{ upsample_7_to_32bit(0x7F) }) },
+              translate(t, cc(3, 4, control_change::data_entry_msb, 0x7F)));
+
+    // RPN null
+    EXPECT_TRUE(translate(t, cc(3, 4, control_change::rpn_msb, 0x7F)).empty());
+    EXPECT_TRUE(translate(t, cc(3, 4, control_change::rpn_lsb, 0x7F)).empty());
+    EXPECT_TRUE(translate(t, cc(3, 4, control_change::data_entry_msb, 0x10)).empty());
+}
+
+//-----------------------------------------------
+
+TEST_F(protocol_translator, midi1_to_midi2_14bit_controllers)
+{
+    using namespace midi;
+
+    midi1_to_midi2_translator t;
+
+    // LSB without MSB is translated as is
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi2_control_change_message(
+                0, 0, control_change::volume + control_change::lsb, controller_value{ uint7_t{ 0x11 } }) },
+              translate(t, cc(0, 0, control_change::volume + control_change::lsb, 0x11)));
+
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi2_control_change_message(
+                0, 0, control_change::volume, controller_value{ uint7_t{ 0x40 } }) },
+              translate(t, cc(0, 0, control_change::volume, 0x40)));
+    EXPECT_EQ(std::vector<universal_packet>{ make_midi2_control_change_message(
+                0, 0, control_change::volume, controller_value{ upsample_14_to_32bit(uint14_t((0x40 << 7) | 0x11)) }) },
+              translate(t, cc(0, 0, control_change::volume + control_change::lsb, 0x11)));
+}
+
+//-----------------------------------------------
+
+TEST_F(protocol_translator, round_trip)
+{
+    using namespace midi;
+
+    const universal_packet packets[] = {
+        make_midi2_note_on_message(0, 0, 60, velocity{ uint7_t{ 100 } }),
+        make_registered_controller_message(0, 0, 0, 1, controller_value{ upsample_14_to_32bit(0x1234) }),
+        make_registered_controller_message(0, 0, 0, 1, controller_value{ upsample_14_to_32bit(0x0567) }),
+        make_assignable_controller_message(0, 1, 2, 3, controller_value{ upsample_14_to_32bit(0x3FFF) }),
+        make_midi2_program_change_message(0, 0, 1, uint14_t(0x0203)),
+    };
+
+    midi2_to_midi1_translator down;
+    midi1_to_midi2_translator up;
+
+    std::vector<universal_packet> result;
+    for (const auto& p : packets)
+        down.translate(p, [&](const universal_packet& m1) {
+            up.translate(m1, [&](const universal_packet& m2) { result.push_back(m2); });
+        });
+
+    // data entry MSB results in an additional 7 bit value
+    const std::vector<universal_packet> expected = {
+        packets[0],
+        make_registered_controller_message(0, 0, 0, 1, controller_value{ upsample_7_to_32bit(0x1234 >> 7) }),
+        packets[1],
+        make_registered_controller_message(0, 0, 0, 1, controller_value{ upsample_7_to_32bit(0x0567 >> 7) }),
+        packets[2],
+        make_assignable_controller_message(0, 1, 2, 3, controller_value{ upsample_7_to_32bit(0x7F) }),
+        packets[3],
+        packets[4],
+    };
+    EXPECT_EQ(expected, result);
+}
+
+//-----------------------------------------------
+
+TEST_F(protocol_translator, bulk_translate_num_out)
+{
+    using namespace midi;
+
+    const universal_packet packets[] = {
+        make_midi2_note_on_message(0, 0, 60, velocity{ uint7_t{ 100 } }),
+        make_registered_controller_message(0, 0, 0, 1, controller_value{ upsample_14_to_32bit(0x1234) }),
+        make_per_note_pitch_bend_message(0, 0, 60, pitch_bend{ uint14_t{ 0x2000 } }),
+        make_registered_controller_message(0, 0, 0, 1, controller_value{ upsample_14_to_32bit(0x0567) }),
+    };
+    constexpr auto num_packets = std::size(packets);
+
+    universal_packet m1[num_packets * midi2_to_midi1_translator::max_packets_per_packet];
+    uint8_t          num_m1[num_packets];
+
+    midi2_to_midi1_translator down;
+    const auto                n = down.translate(packets, num_packets, m1, num_m1);
+    EXPECT_EQ(7u, n);
+    EXPECT_EQ(1u, num_m1[0]);
+    EXPECT_EQ(4u, num_m1[1]);
+    EXPECT_EQ(0u, num_m1[2]);
+    EXPECT_EQ(2u, num_m1[3]);
+
+    universal_packet m2[std::size(m1)];
+    uint8_t          num_m2[std::size(m1)];
+
+    midi1_to_midi2_translator up;
+    EXPECT_EQ(5u, up.translate(m1, n, m2, num_m2));
+    const uint8_t expected[] = { 1, 0, 0, 1, 1, 1, 1 };
+    for (size_t i = 0; i < std::size(expected); ++i)
+        EXPECT_EQ(expected[i], num_m2[i]) << "packet " << i;
+}
+
+//-----------------------------------------------
+
+TEST_F(protocol_translator, convert_midi1_to_midi2)
+{
+    using namespace midi;
+
+    std::mt19937 rng{ 42 };
+
+    std::vector<universal_packet> packets;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const auto w = uint32_t(rng());
+        if (i % 10 == 0)
+            packets.push_back(make_system_message(group_t(w & 0x0F), system_status::clock));
+        else
+            packets.push_back(universal_packet{ 0x20800000u | (w & 0x0F7F7F7Fu) });
+    }
+
+    std::vector<universal_packet> expected;
+    std::vector<uint8_t>          expected_num_out;
+    for (const auto& p : packets)
+    {
+        const auto n = expected.size();
+        if (p.type() != packet_type::midi1_channel_voice)
+            expected.push_back(p);
+        else if (const auto m2 = as_midi2_channel_voice_message(midi1_channel_voice_message_view{ p }))
+            expected.push_back(*m2);
+        expected_num_out.push_back(uint8_t(expected.size() - n));
+    }
+
+    std::vector<universal_packet> result(packets.size());
+    std::vector<uint8_t>          num_out(packets.size());
+    result.resize(convert_midi1_to_midi2(packets.data(), packets.size(), result.data(), num_out.data()));
+
+    EXPECT_EQ(expected, result);
+    EXPECT_EQ(expected_num_out, num_out);
+}
+
+//-----------------------------------------------
+
+TEST_F(protocol_translator, convert_midi2_to_midi1)
+{
+    using namespace midi;
+
+    std::mt19937 rng{ 42 };
+
+    std::vector<universal_packet> packets;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const auto w = uint32_t(rng());
+        if (i % 10 == 0)
+            packets.push_back(make_system_message(group_t(w & 0x0F), system_status::clock));
+        else // mostly without note attributes and bank
+            packets.push_back(universal_packet{ 0x40800000u | (w & 0x0F7F7F00u) | ((i % 3 == 0) ? (w >> 24) : 0),
+                                                uint32_t(rng()) });
+    }
+
+    std::vector<universal_packet> expected;
+    std::vector<uint8_t>          expected_num_out;
+    for (const auto& p : packets)
+    {
+        const auto n = expected.size();
+        if (p.type() != packet_type::midi2_channel_voice)
+            expected.push_back(p);
+        else if (const auto m1 = as_midi1_channel_voice_message(midi2_channel_voice_message_view{ p }))
+            expected.push_back(*m1);
+        expected_num_out.push_back(uint8_t(expected.size() - n));
+    }
+
+    std::vector<universal_packet> result(packets.size());
+    std::vector<uint8_t>          num_out(packets.size());
+    result.resize(convert_midi2_to_midi1(packets.data(), packets.size(), result.data(), num_out.data()));
+
+    EXPECT_EQ(expected, result);
+    EXPECT_EQ(expected_num_out, num_out);
+}
+
+//-----------------------------------------------
+
+TEST_F(protocol_translator, convert_midi2_to_midi1_all_index_and_attribute_bytes)
+{
+    using namespace midi;
+
+    std::mt19937 rng{ 42 };
+
+    // index and attribute bytes beyond 7 bits are masked like in the message view
+    for (uint32_t status = 0; status < 16; ++status)
+    {
+        std::vector<universal_packet> packets;
+        for (uint32_t bytes = 0; bytes < 0x10000; ++bytes)
+        {
+            const auto w = 0x40000000u | (uint32_t(rng()) & 0x0F0F0000u) | (status << 20) | bytes;
+            packets.push_back(universal_packet{ w, uint32_t(rng()) });
+        }
+
+        std::vector<universal_packet> expected;
+        for (const auto& p : packets)
+            if (const auto m1 = as_midi1_channel_voice_message(midi2_channel_voice_message_view{ p }))
+                expected.push_back(*m1);
+
+        std::vector<universal_packet> result(packets.size());
+        result.resize(convert_midi2_to_midi1(packets.data(), packets.size(), result.data()));
+
+        EXPECT_EQ(expected, result) << "status " << (status << 4);
+    }
+}
+
+//-----------------------------------------------
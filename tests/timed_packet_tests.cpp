@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/timed_packet.h>
+
+#include <vector>
+
+//-----------------------------------------------
+
+class timed_packet_merge : public ::testing::Test
+{
+  public:
+    static midi::timed_packet make(uint16_t timestamp, uint32_t word)
+    {
+        return midi::timed_packet{ midi::jr_timestamp_t{ timestamp }, midi::universal_packet{ word } };
+    }
+};
+
+//-----------------------------------------------
+
+TEST_F(timed_packet_merge, is_earlier)
+{
+    using namespace midi;
+
+    EXPECT_TRUE(is_earlier(jr_timestamp_t{ 1 }, jr_timestamp_t{ 2 }));
+    EXPECT_FALSE(is_earlier(jr_timestamp_t{ 2 }, jr_timestamp_t{ 1 }));
+    EXPECT_FALSE(is_earlier(jr_timestamp_t{ 2 }, jr_timestamp_t{ 2 }));
+
+    // wrap around
+    EXPECT_TRUE(is_earlier(jr_timestamp_t{ 0xFFF0 }, jr_timestamp_t{ 0x0010 }));
+    EXPECT_FALSE(is_earlier(jr_timestamp_t{ 0x0010 }, jr_timestamp_t{ 0xFFF0 }));
+}
+
+//-----------------------------------------------
+
+TEST_F(timed_packet_merge, empty)
+{
+    using namespace midi;
+
+    timed_packet_merger m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_FALSE(m.next());
+
+    m.add_stream(nullptr, size_t{ 0 });
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(0u, m.merge([](const timed_packet&) { FAIL(); }));
+}
+
+//-----------------------------------------------
+
+TEST_F(timed_packet_merge, merge_streams)
+{
+    using namespace midi;
+
+    const timed_packet a[] = { make(10, 0xA0), make(20, 0xA1), make(40, 0xA2) };
+    const timed_packet b[] = { make(5, 0xB0), make(30, 0xB1) };
+    const timed_packet c[] = { make(15, 0xC0), make(50, 0xC1), make(60, 0xC2), make(70, 0xC3) };
+
+    timed_packet_merger m;
+    m.add_stream(a, 3);
+    m.add_stream(b, 2);
+    m.add_stream(c, 4);
+    EXPECT_EQ(3u, m.num_active_streams());
+
+    std::vector<uint16_t> timestamps;
+    std::vector<uint32_t> words;
+    EXPECT_EQ(9u, m.merge([&](const timed_packet& p) {
+        timestamps.push_back(p.timestamp.value);
+        words.push_back(p.packet.data[0]);
+    }));
+    EXPECT_TRUE(m.empty());
+
+    EXPECT_EQ((std::vector<uint16_t>{ 5, 10, 15, 20, 30, 40, 50, 60, 70 }), timestamps);
+    EXPECT_EQ((std::vector<uint32_t>{ 0xB0, 0xA0, 0xC0, 0xA1, 0xB1, 0xA2, 0xC1, 0xC2, 0xC3 }), words);
+}
+
+//-----------------------------------------------
+
+TEST_F(timed_packet_merge, equal_timestamps_keep_stream_order)
+{
+    using namespace midi;
+
+    const timed_packet a[] = { make(10, 0xA0), make(10, 0xA1), make(20, 0xA2) };
+    const timed_packet b[] = { make(10, 0xB0), make(20, 0xB1) };
+
+    timed_packet_merger m;
+    m.add_stream(b, 2);
+    m.add_stream(a, 3);
+
+    timed_packet out[8];
+    ASSERT_EQ(5u, m.merge(out, 8));
+    EXPECT_EQ(0xB0u, out[0].packet.data[0]);
+    EXPECT_EQ(0xA0u, out[1].packet.data[0]);
+    EXPECT_EQ(0xA1u, out[2].packet.data[0]);
+    EXPECT_EQ(0xB1u, out[3].packet.data[0]);
+    EXPECT_EQ(0xA2u, out[4].packet.data[0]);
+}
+
+//-----------------------------------------------
+
+TEST_F(timed_packet_merge, timestamp_wrap_around)
+{
+    using namespace midi;
+
+    const timed_packet a[] = { make(0xFFF0, 0xA0), make(0x0005, 0xA1) };
+    const timed_packet b[] = { make(0xFFFF, 0xB0), make(0x0001, 0xB1) };
+
+    timed_packet_merger m;
+    m.add_stream(a, 2);
+    m.add_stream(b, 2);
+
+    EXPECT_EQ(0xA0u, m.next()->packet.data[0]);
+    EXPECT_EQ(0xB0u, m.next()->packet.data[0]);
+    EXPECT_EQ(0xB1u, m.next()->packet.data[0]);
+    EXPECT_EQ(0xA1u, m.next()->packet.data[0]);
+    EXPECT_FALSE(m.next());
+}
+
+//-----------------------------------------------
+
+TEST_F(timed_packet_merge, partial_merge)
+{
+    using namespace midi;
+
+    const timed_packet a[] = { make(1, 0xA0), make(3, 0xA1), make(5, 0xA2) };
+    const timed_packet b[] = { make(2, 0xB0), make(4, 0xB1), make(6, 0xB2) };
+
+    timed_packet_merger m;
+    m.add_stream(a, 3);
+    m.add_stream(b, 3);
+
+    timed_packet out[4];
+    ASSERT_EQ(4u, m.merge(out, 4));
+    EXPECT_EQ(4u, out[3].timestamp.value);
+    EXPECT_EQ(2u, m.num_active_streams());
+
+    ASSERT_EQ(2u, m.merge(out, 4));
+    EXPECT_EQ(5u, out[0].timestamp.value);
+    EXPECT_EQ(6u, out[1].timestamp.value);
+    EXPECT_TRUE(m.empty());
+
+    m.clear();
+    m.add_stream(std::begin(a), std::end(a));
+    EXPECT_EQ(3u, m.merge([](const timed_packet&) {}));
+}
+
+//-----------------------------------------------
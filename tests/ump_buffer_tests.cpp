@@ -0,0 +1,151 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/ump_buffer.h>
+
+#include <midi/data_message.h>
+#include <midi/midi1_channel_voice_message.h>
+#include <midi/midi2_channel_voice_message.h>
+#include <midi/system_message.h>
+
+#include <vector>
+
+//-----------------------------------------------
+
+class ump_buffer : public ::testing::Test
+{
+  public:
+    const std::vector<midi::universal_packet> packets = {
+        midi::make_midi1_note_on_message(3, 2, 60, midi::velocity{ midi::uint7_t{ 100 } }),
+        midi::make_midi2_note_off_message(1, 5, 70, midi::velocity{ midi::uint16_t{ 0x1234 } }),
+        midi::universal_packet{ 0x50001122, 0x33445566, 0x778899AA, 0xBBCCDDEE },
+        midi::make_system_message(7, midi::system_status::clock),
+        midi::universal_packet{ 0x30160102, 0x03040506 },
+        midi::make_midi1_control_change_message(0, 0, 7, midi::controller_value{ midi::uint7_t{ 99 } }),
+    };
+};
+
+//-----------------------------------------------
+
+TEST_F(ump_buffer, empty)
+{
+    midi::ump_buffer b;
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(0u, b.size());
+    EXPECT_EQ(0u, b.size_in_words());
+    EXPECT_FALSE(b.has_index());
+    EXPECT_EQ(b.begin(), b.end());
+
+    midi::ump_buffer i{ true };
+    EXPECT_TRUE(i.empty());
+    EXPECT_TRUE(i.has_index());
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_buffer, push_back)
+{
+    midi::ump_buffer b;
+    for (const auto& p : packets)
+        b.push_back(p);
+
+    EXPECT_FALSE(b.empty());
+    EXPECT_EQ(packets.size(), b.size());
+    EXPECT_EQ(11u, b.size_in_words()); // 1 + 2 + 4 + 1 + 2 + 1
+
+    auto expected = packets.begin();
+    for (auto v : b)
+    {
+        ASSERT_NE(expected, packets.end());
+        EXPECT_EQ(*expected, v.packet());
+        ++expected;
+    }
+    EXPECT_EQ(expected, packets.end());
+
+    b.clear();
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(0u, b.size_in_words());
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_buffer, random_access)
+{
+    midi::ump_buffer b{ true };
+    b.reserve(16);
+    for (const auto& p : packets)
+        b.push_back(p);
+
+    for (auto i = 0u; i < packets.size(); ++i)
+    {
+        EXPECT_EQ(packets[i], b[i].packet());
+        EXPECT_EQ(packets[i], b.packet(i));
+    }
+
+    // enable index later
+    midi::ump_buffer c;
+    for (const auto& p : packets)
+        c.push_back(p);
+    EXPECT_FALSE(c.has_index());
+    c.enable_index(true);
+    EXPECT_TRUE(c.has_index());
+    for (auto i = 0u; i < packets.size(); ++i)
+        EXPECT_EQ(packets[i], c.packet(i));
+
+    c.push_back(packets[2]);
+    EXPECT_EQ(packets[2], c.packet(packets.size()));
+
+    c.enable_index(false);
+    EXPECT_FALSE(c.has_index());
+    EXPECT_EQ(packets.size() + 1, c.size());
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_buffer, append_words)
+{
+    std::vector<midi::uint32_t> words;
+    for (const auto& p : packets)
+        words.insert(words.end(), p.data, p.data + p.size());
+    words.push_back(0x40903C00); // incomplete
+
+    midi::ump_buffer b{ true };
+    b.push_back(packets[0]);
+
+    EXPECT_EQ(words.size() - 1, b.append(words.data(), words.size()));
+    EXPECT_EQ(packets.size() + 1, b.size());
+    EXPECT_EQ(packets[0], b.packet(0));
+    for (auto i = 0u; i < packets.size(); ++i)
+        EXPECT_EQ(packets[i], b.packet(i + 1));
+
+    EXPECT_EQ(0u, b.append(words.data() + words.size() - 1, 1));
+    EXPECT_EQ(packets.size() + 1, b.size());
+
+    midi::ump_buffer c;
+    c.append(b.data(), b.size_in_words());
+    EXPECT_EQ(b.size(), c.size());
+    EXPECT_EQ(b.view().num_packets(), c.view().num_packets());
+}
+
+//-----------------------------------------------
@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/ump_capture_file.h>
+
+#include <midi/midi1_channel_voice_message.h>
+#include <midi/stream_message.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------
+
+class ump_capture_file : public ::testing::Test
+{
+  public:
+    std::string path() const
+    {
+        return ::testing::TempDir() + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".umpc";
+    }
+
+    void write(const std::vector<uint32_t>& words, size_t num_extra_bytes = 0) const
+    {
+        std::FILE* file = std::fopen(path().c_str(), "wb");
+        ASSERT_NE(nullptr, file);
+        EXPECT_TRUE(midi::write_ump_capture_header(file));
+        EXPECT_EQ(words.size(), std::fwrite(words.data(), sizeof(uint32_t), words.size(), file));
+        for (auto i = 0u; i < num_extra_bytes; ++i)
+            std::fputc(0xAA, file);
+        std::fclose(file);
+    }
+
+    void TearDown() override { std::remove(path().c_str()); }
+};
+
+//-----------------------------------------------
+
+TEST_F(ump_capture_file, open)
+{
+    using namespace midi;
+
+    midi::ump_capture_file f;
+    EXPECT_FALSE(f.is_open());
+    EXPECT_FALSE(f.open(path().c_str()));
+    EXPECT_TRUE(f.packets().empty());
+
+    write({});
+    EXPECT_TRUE(f.open(path().c_str()));
+    EXPECT_TRUE(f.is_open());
+    EXPECT_TRUE(f.packets().empty());
+    EXPECT_FALSE(f.is_truncated());
+
+    f.close();
+    EXPECT_FALSE(f.is_open());
+
+    // invalid header
+    std::FILE* file = std::fopen(path().c_str(), "wb");
+    ASSERT_NE(nullptr, file);
+    const char garbage[] = "this is not a capture file";
+    std::fwrite(garbage, 1, sizeof(garbage), file);
+    std::fclose(file);
+    EXPECT_FALSE(f.open(path().c_str()));
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_capture_file, packets)
+{
+    using namespace midi;
+
+    const auto note_on = make_midi1_note_on_message(1, 2, note_nr_t{ 60 }, velocity{ uint7_t{ 100 } });
+    const auto request = make_stream_configuration_request(protocol::midi2);
+    write({ note_on.data[0],
+            request.data[0],
+            request.data[1],
+            request.data[2],
+            request.data[3],
+            0x40903C00,
+            0x80000000 });
+
+    midi::ump_capture_file f;
+    ASSERT_TRUE(f.open(path().c_str()));
+    EXPECT_EQ(7u, f.size_in_words());
+    EXPECT_FALSE(f.is_truncated());
+
+    const auto view = f.packets();
+    ASSERT_EQ(3u, view.num_packets());
+    auto it = view.begin();
+    EXPECT_EQ(note_on, (*it++).packet());
+    EXPECT_EQ(request, (*it++).packet());
+    EXPECT_EQ(packet_type::midi2_channel_voice, (*it).type());
+
+    // move ownership
+    midi::ump_capture_file g{ std::move(f) };
+    EXPECT_FALSE(f.is_open());
+    EXPECT_TRUE(g.is_open());
+    EXPECT_EQ(3u, g.packets().num_packets());
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_capture_file, truncated)
+{
+    using namespace midi;
+
+    write({ 0x20903C40, 0x40903C00 }, 2);
+
+    midi::ump_capture_file f;
+    ASSERT_TRUE(f.open(path().c_str()));
+    EXPECT_TRUE(f.is_truncated());
+    EXPECT_EQ(1u, f.num_truncated_words());
+    EXPECT_EQ(2u, f.num_trailing_bytes());
+    EXPECT_EQ(1u, f.packets().num_packets());
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_capture_file, time_index)
+{
+    using namespace midi;
+
+    std::vector<uint32_t> words;
+    uint16_t              timestamp = 0xF000; // wraps around
+    for (auto i = 0u; i < 100; ++i)
+    {
+        words.push_back(jr_timestamp_message{ jr_timestamp_t{ timestamp } }.data[0]);
+        words.push_back(0x20903C40 | i);
+        timestamp = uint16_t(timestamp + 1000);
+    }
+    write(words);
+
+    midi::ump_capture_file f;
+    ASSERT_TRUE(f.open(path().c_str()));
+
+    EXPECT_EQ(200u, f.packets_from(jr_ticks{ 50000 }).num_packets());
+
+    f.build_time_index(jr_ticks{ 10000 });
+    ASSERT_EQ(10u, f.time_index().size());
+    EXPECT_EQ(jr_ticks{ 0 }, f.time_index()[0].ticks);
+    EXPECT_EQ(0u, f.time_index()[0].word_offset);
+    EXPECT_EQ(jr_ticks{ 10000 }, f.time_index()[1].ticks);
+    EXPECT_EQ(20u, f.time_index()[1].word_offset);
+
+    const auto v = f.packets_from(jr_ticks{ 55000 });
+    EXPECT_EQ(100u, v.num_packets());
+    EXPECT_EQ(jr_timestamp_message{ jr_timestamp_t{ uint16_t(0xF000 + 50000) } }, (*v.begin()).packet());
+
+    EXPECT_EQ(200u, f.packets_from(jr_ticks{ -1 }).num_packets());
+    EXPECT_EQ(20u, f.packets_from(jr_ticks{ 1000000 }).num_packets());
+}
+
+//-----------------------------------------------
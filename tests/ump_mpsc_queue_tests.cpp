@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/ump_mpsc_queue.h>
+
+#include <midi/midi1_channel_voice_message.h>
+
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------
+
+class ump_mpsc_queue : public ::testing::Test
+{
+  public:
+};
+
+//-----------------------------------------------
+
+TEST_F(ump_mpsc_queue, capacity)
+{
+    EXPECT_EQ(2u, midi::ump_mpsc_queue{ 0 }.capacity());
+    EXPECT_EQ(2u, midi::ump_mpsc_queue{ 2 }.capacity());
+    EXPECT_EQ(4u, midi::ump_mpsc_queue{ 3 }.capacity());
+    EXPECT_EQ(256u, midi::ump_mpsc_queue{ 200 }.capacity());
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_mpsc_queue, push_pop)
+{
+    using namespace midi;
+
+    midi::ump_mpsc_queue q{ 4 };
+    EXPECT_FALSE(q.try_pop());
+
+    auto a = q.make_producer(1);
+    auto b = q.make_producer(7);
+    EXPECT_EQ(1u, a.source());
+    EXPECT_EQ(7u, b.source());
+    EXPECT_EQ(0u, a.next_sequence());
+
+    const auto p1 = make_midi1_note_on_message(0, 0, 60, velocity{ uint7_t{ 100 } });
+    const auto p2 = make_midi1_note_off_message(0, 0, 60, velocity{ uint7_t{ 0 } });
+
+    EXPECT_TRUE(a.try_push(p1));
+    EXPECT_TRUE(b.try_push(p2));
+    EXPECT_TRUE(a.try_push(p2));
+    EXPECT_TRUE(q.try_push({ p1, 99, 1234 }));
+    EXPECT_FALSE(b.try_push(p1)); // full
+    EXPECT_EQ(2u, a.next_sequence());
+    EXPECT_EQ(1u, b.next_sequence());
+
+    auto e = q.try_pop();
+    ASSERT_TRUE(e);
+    EXPECT_EQ(p1, e->packet);
+    EXPECT_EQ(1u, e->source);
+    EXPECT_EQ(0u, e->sequence);
+
+    e = q.try_pop();
+    ASSERT_TRUE(e);
+    EXPECT_EQ(p2, e->packet);
+    EXPECT_EQ(7u, e->source);
+    EXPECT_EQ(0u, e->sequence);
+
+    EXPECT_TRUE(b.try_push(p1));
+    EXPECT_EQ(2u, b.next_sequence());
+
+    e = q.try_pop();
+    ASSERT_TRUE(e);
+    EXPECT_EQ(p2, e->packet);
+    EXPECT_EQ(1u, e->source);
+    EXPECT_EQ(1u, e->sequence);
+
+    e = q.try_pop();
+    ASSERT_TRUE(e);
+    EXPECT_EQ(99u, e->source);
+    EXPECT_EQ(1234u, e->sequence);
+
+    e = q.try_pop();
+    ASSERT_TRUE(e);
+    EXPECT_EQ(p1, e->packet);
+    EXPECT_EQ(7u, e->source);
+    EXPECT_EQ(1u, e->sequence);
+
+    EXPECT_FALSE(q.try_pop());
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_mpsc_queue, producer_threads)
+{
+    using namespace midi;
+
+    constexpr uint16_t num_producers = 8;
+    constexpr uint32_t num_packets   = 20000;
+
+    midi::ump_mpsc_queue q{ 64 };
+
+    std::vector<std::thread> producers;
+    for (uint16_t s = 0; s < num_producers; ++s)
+    {
+        producers.emplace_back([&q, s]() {
+            auto p = q.make_producer(s);
+            for (uint32_t i = 0; i < num_packets;)
+            {
+                if (p.try_push(universal_packet{ 0x40000000u | (uint32_t(s) << 24), i }))
+                    ++i;
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<uint32_t> next_sequence(num_producers, 0);
+    for (uint32_t received = 0; received < num_producers * num_packets;)
+    {
+        if (auto e = q.try_pop())
+        {
+            ASSERT_LT(e->source, num_producers);
+            EXPECT_EQ(e->source, e->packet.group());
+            EXPECT_EQ(next_sequence[e->source], e->sequence);
+            EXPECT_EQ(next_sequence[e->source], e->packet.data[1]);
+            ++next_sequence[e->source];
+            ++received;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    for (auto& t : producers)
+        t.join();
+
+    EXPECT_FALSE(q.try_pop());
+    for (auto s : next_sequence)
+        EXPECT_EQ(num_packets, s);
+}
+
+//-----------------------------------------------
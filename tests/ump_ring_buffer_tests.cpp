@@ -0,0 +1,238 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/ump_ring_buffer.h>
+
+#include <midi/midi1_channel_voice_message.h>
+#include <midi/midi2_channel_voice_message.h>
+#include <midi/ump_stream.h>
+
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------
+
+class ump_ring_buffer : public ::testing::Test
+{
+  public:
+};
+
+//-----------------------------------------------
+
+TEST_F(ump_ring_buffer, capacity)
+{
+    EXPECT_EQ(8u, midi::ump_ring_buffer{ 0 }.capacity());
+    EXPECT_EQ(8u, midi::ump_ring_buffer{ 5 }.capacity());
+    EXPECT_EQ(8u, midi::ump_ring_buffer{ 8 }.capacity());
+    EXPECT_EQ(16u, midi::ump_ring_buffer{ 9 }.capacity());
+    EXPECT_EQ(1024u, midi::ump_ring_buffer{ 1000 }.capacity());
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_ring_buffer, push_pop)
+{
+    using namespace midi;
+
+    midi::ump_ring_buffer r{ 8 };
+    EXPECT_TRUE(r.empty());
+    EXPECT_FALSE(r.try_pop());
+
+    const auto p1 = make_midi1_note_on_message(1, 2, 60, velocity{ uint7_t{ 100 } });
+    const auto p2 = make_midi2_note_on_message(3, 4, 62, velocity{ uint16_t{ 0x8000 } });
+    const auto p4 = universal_packet{ 0x50001122, 0x33445566, 0x778899AA, 0xBBCCDDEE };
+
+    EXPECT_TRUE(r.try_push(p1));
+    EXPECT_TRUE(r.try_push(p2));
+    EXPECT_TRUE(r.try_push(p4));
+    EXPECT_FALSE(r.empty());
+    EXPECT_TRUE(r.try_push(p1));
+    EXPECT_FALSE(r.try_push(p1)); // full
+
+    EXPECT_EQ(p1, r.try_pop());
+    EXPECT_EQ(p2, r.try_pop());
+    EXPECT_EQ(p4, r.try_pop());
+    EXPECT_EQ(p1, r.try_pop());
+    EXPECT_TRUE(r.empty());
+    EXPECT_FALSE(r.try_pop());
+
+    // 4 word packet does not fit into the two remaining words at the end of the ring
+    EXPECT_TRUE(r.try_push(p2));
+    EXPECT_TRUE(r.try_push(p2));
+    EXPECT_TRUE(r.try_push(p2));
+    EXPECT_EQ(p2, r.try_pop());
+    EXPECT_EQ(p2, r.try_pop());
+    EXPECT_TRUE(r.try_push(p4)); // skips two words at the end
+    EXPECT_FALSE(r.try_push(p1));
+
+    EXPECT_EQ(p2, r.try_pop());
+    EXPECT_EQ(p4, r.try_pop());
+    EXPECT_TRUE(r.empty());
+    EXPECT_FALSE(r.try_pop());
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_ring_buffer, wrap_around)
+{
+    using namespace midi;
+
+    midi::ump_ring_buffer r{ 16 };
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        const auto p = universal_packet{ (i % 16) << 28 | i, i + 1, i + 2, i + 3 };
+        ASSERT_TRUE(r.try_push(p));
+        ASSERT_TRUE(r.try_push(make_midi1_note_off_message(0, 0, uint7_t(i & 0x7F), velocity{})));
+
+        auto o = r.try_pop();
+        ASSERT_TRUE(o);
+        EXPECT_EQ(p, *o);
+        EXPECT_EQ(p.size(), o->size());
+        o = r.try_pop();
+        ASSERT_TRUE(o);
+        EXPECT_EQ(make_midi1_note_off_message(0, 0, uint7_t(i & 0x7F), velocity{}), *o);
+        EXPECT_TRUE(r.empty());
+    }
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_ring_buffer, bulk_read_write)
+{
+    using namespace midi;
+
+    const uint32_t words[] = { 0x20903C64, 0x40912233, 0x12345678, 0x10F80000, 0x50001122, 0x1, 0x2, 0x3, 0x20803C00 };
+
+    midi::ump_ring_buffer r{ 8 };
+
+    // only complete packets that fit are written
+    EXPECT_EQ(8u, r.write(words, 9));
+    EXPECT_EQ(0u, r.write(words + 8, 1));
+
+    uint32_t out[16]{};
+    // only complete packets that fit are read
+    EXPECT_EQ(3u, r.read(out, 3));
+    EXPECT_EQ(0x20903C64u, out[0]);
+    EXPECT_EQ(0x40912233u, out[1]);
+    EXPECT_EQ(0x12345678u, out[2]);
+    EXPECT_EQ(5u, r.read(out, 16));
+    EXPECT_EQ(0x10F80000u, out[0]);
+    EXPECT_EQ(0x50001122u, out[1]);
+    EXPECT_EQ(0x3u, out[4]);
+    EXPECT_EQ(0u, r.read(out, 16));
+    EXPECT_TRUE(r.empty());
+
+    // wrap with padding
+    const uint32_t two_word_packets[] = { 0x40900000, 0x1, 0x40900001, 0x2, 0x40900002, 0x3 };
+    EXPECT_EQ(6u, r.write(two_word_packets, 6));
+    EXPECT_EQ(4u, r.read(out, 4));
+    EXPECT_EQ(4u, r.write(words + 4, 4)); // skips two words at the end
+    EXPECT_EQ(0u, r.write(words, 1));
+
+    EXPECT_EQ(2u, r.read(out, 5));
+    EXPECT_EQ(0x40900002u, out[0]);
+    EXPECT_EQ(0u, r.read(out, 3));
+    EXPECT_EQ(4u, r.read(out, 16));
+    EXPECT_EQ(0x50001122u, out[0]);
+    EXPECT_EQ(0x3u, out[3]);
+    EXPECT_TRUE(r.empty());
+
+    // incomplete packet in input
+    EXPECT_EQ(0u, r.write(words + 4, 3));
+    EXPECT_TRUE(r.empty());
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_ring_buffer, producer_consumer_threads)
+{
+    using namespace midi;
+
+    constexpr uint32_t num_packets = 100000;
+
+    midi::ump_ring_buffer r{ 64 };
+
+    std::thread producer{ [&r]() {
+        for (uint32_t i = 0; i < num_packets;)
+        {
+            // alternate packet sizes 1, 2, 4
+            universal_packet p;
+            switch (i % 3)
+            {
+            case 0:
+                p = universal_packet{ 0x20000000u | (i & 0xFFFFFF) };
+                break;
+            case 1:
+                p = universal_packet{ 0x40000000u | (i & 0xFFFFFF), i };
+                break;
+            default:
+                p = universal_packet{ 0x50000000u | (i & 0xFFFFFF), i, ~i, i * 3 };
+                break;
+            }
+            if (r.try_push(p))
+                ++i;
+            else
+                std::this_thread::yield();
+        }
+    } };
+
+    uint32_t              expected = 0;
+    std::vector<uint32_t> buffer(32);
+    while (expected < num_packets)
+    {
+        const auto num_words = r.read(buffer.data(), buffer.size());
+        if (num_words == 0)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        for (auto v : ump_stream_view{ buffer.data(), num_words })
+        {
+            ASSERT_EQ(expected & 0xFFFFFF, v[0] & 0xFFFFFF);
+            switch (expected % 3)
+            {
+            case 0:
+                ASSERT_EQ(packet_type::midi1_channel_voice, v.type());
+                break;
+            case 1:
+                ASSERT_EQ(packet_type::midi2_channel_voice, v.type());
+                ASSERT_EQ(expected, v[1]);
+                break;
+            default:
+                ASSERT_EQ(packet_type::extended_data, v.type());
+                ASSERT_EQ(~expected, v[2]);
+                ASSERT_EQ(expected * 3, v[3]);
+                break;
+            }
+            ++expected;
+        }
+    }
+
+    producer.join();
+    EXPECT_TRUE(r.empty());
+}
+
+//-----------------------------------------------
@@ -0,0 +1,262 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/ump_serialization.h>
+
+#include <midi/midi2_channel_voice_message.h>
+#include <midi/stream_message.h>
+#include <midi/system_message.h>
+
+#include <vector>
+
+//-----------------------------------------------
+
+class ump_serialization : public ::testing::Test
+{
+  public:
+    static std::vector<midi::universal_packet> make_packets()
+    {
+        using namespace midi;
+
+        return { make_system_message(0, system_status::clock),
+                 make_midi2_note_on_message(1, 2, note_nr_t{ 60 }, velocity{ uint16_t{ 0x8000 } }),
+                 universal_packet{ 0x30010203, 0x04050607 },
+                 make_stream_configuration_request(protocol::midi2),
+                 universal_packet{ 0x21904060 } };
+    }
+};
+
+//-----------------------------------------------
+
+TEST_F(ump_serialization, header)
+{
+    using namespace midi;
+
+    uint8_t buffer[ump_record_header_size];
+    EXPECT_EQ(0u, write_ump_record_header(ump_record_format{}, buffer, 7));
+
+    const ump_record_format f{ byte_order::big_endian, true };
+    EXPECT_EQ(ump_record_header_size, write_ump_record_header(f, buffer, sizeof(buffer)));
+    EXPECT_EQ('U', buffer[0]);
+    EXPECT_EQ('B', buffer[3]);
+    EXPECT_EQ(ump_record_format_version, buffer[4]);
+
+    const auto r = read_ump_record_header(buffer, sizeof(buffer));
+    ASSERT_TRUE(r);
+    EXPECT_EQ(f, *r);
+
+    EXPECT_FALSE(read_ump_record_header(buffer, 7));
+    buffer[1] = 'X';
+    EXPECT_FALSE(read_ump_record_header(buffer, sizeof(buffer)));
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_serialization, byte_order)
+{
+    using namespace midi;
+
+    const universal_packet p{ 0x20903C40 };
+    uint8_t                buffer[8];
+    size_t                 n = 0;
+
+    EXPECT_EQ(5u, write_ump_records(ump_record_format{}, &p, nullptr, 1, buffer, sizeof(buffer), n));
+    EXPECT_EQ(1u, n);
+    EXPECT_EQ((std::vector<uint8_t>{ 1, 0x40, 0x3C, 0x90, 0x20 }), std::vector<uint8_t>(buffer, buffer + 5));
+
+    EXPECT_EQ(5u,
+              write_ump_records(
+                ump_record_format{ byte_order::big_endian, false }, &p, nullptr, 1, buffer, sizeof(buffer), n));
+    EXPECT_EQ((std::vector<uint8_t>{ 1, 0x20, 0x90, 0x3C, 0x40 }), std::vector<uint8_t>(buffer, buffer + 5));
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_serialization, buffer_round_trip)
+{
+    using namespace midi;
+
+    const auto                  packets    = make_packets();
+    const std::vector<uint64_t> timestamps = { 1, 2, 0x1122334455667788ull, 4, 5 };
+
+    for (auto order : { byte_order::little_endian, byte_order::big_endian })
+    {
+        for (auto with_timestamps : { false, true })
+        {
+            const ump_record_format format{ order, with_timestamps };
+
+            std::vector<uint8_t> buffer(256);
+            size_t               num_written = 0;
+            const auto           num_bytes   = write_ump_records(
+              format, packets.data(), timestamps.data(), packets.size(), buffer.data(), buffer.size(), num_written);
+            EXPECT_EQ(packets.size(), num_written);
+            EXPECT_EQ((with_timestamps ? 45u : 5u) + 4 * (1 + 2 + 2 + 4 + 1), num_bytes);
+
+            std::vector<universal_packet> result(8);
+            std::vector<uint64_t>         result_timestamps(8);
+            size_t                        num_read = 0;
+            EXPECT_EQ(num_bytes,
+                      read_ump_records(format,
+                                       buffer.data(),
+                                       num_bytes,
+                                       result.data(),
+                                       result_timestamps.data(),
+                                       result.size(),
+                                       num_read));
+            ASSERT_EQ(packets.size(), num_read);
+            for (auto i = 0u; i < num_read; ++i)
+            {
+                EXPECT_EQ(packets[i], result[i]);
+                EXPECT_EQ(with_timestamps ? timestamps[i] : 0u, result_timestamps[i]);
+            }
+        }
+    }
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_serialization, partial_buffers)
+{
+    using namespace midi;
+
+    const auto              packets = make_packets();
+    const ump_record_format format{ byte_order::little_endian, true };
+
+    // output buffer too small for all records
+    std::vector<uint8_t> buffer(40);
+    size_t               num_written = 0;
+    EXPECT_EQ(30u,
+              write_ump_records(
+                format, packets.data(), nullptr, packets.size(), buffer.data(), buffer.size(), num_written));
+    EXPECT_EQ(2u, num_written);
+
+    // truncated input
+    universal_packet result[4];
+    size_t           num_read = 0;
+    EXPECT_EQ(13u, read_ump_records(format, buffer.data(), 29, result, nullptr, 4, num_read));
+    EXPECT_EQ(1u, num_read);
+    EXPECT_EQ(packets[0], result[0]);
+
+    // invalid word count
+    buffer[13] = 3;
+    EXPECT_EQ(13u, read_ump_records(format, buffer.data(), 30, result, nullptr, 4, num_read));
+    EXPECT_EQ(1u, num_read);
+
+    // nothing stored for the rejected record
+    uint64_t timestamps[4] = { 11, 22, 33, 44 };
+    EXPECT_EQ(13u, read_ump_records(format, buffer.data(), 30, result, timestamps, 4, num_read));
+    EXPECT_EQ(1u, num_read);
+    EXPECT_EQ(0u, timestamps[0]);
+    EXPECT_EQ(22u, timestamps[1]);
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_serialization, file_rejected_records)
+{
+    using namespace midi;
+
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(nullptr, file);
+
+    const auto              packets = make_packets();
+    const ump_record_format format{ byte_order::little_endian, true };
+
+    std::vector<uint8_t> buffer(100);
+    size_t               num_written = 0;
+    const auto           num_bytes =
+      write_ump_records(format, packets.data(), nullptr, 2, buffer.data(), buffer.size(), num_written);
+    ASSERT_EQ(30u, num_bytes);
+
+    // incomplete second record
+    ASSERT_EQ(29u, std::fwrite(buffer.data(), 1, 29, file));
+    std::rewind(file);
+
+    universal_packet result[4];
+    uint64_t         timestamps[4] = { 11, 22, 33, 44 };
+    EXPECT_EQ(1u, read_ump_records(file, format, result, timestamps, 4));
+    EXPECT_EQ(packets[0], result[0]);
+    EXPECT_EQ(22u, timestamps[1]);
+    EXPECT_EQ(13, std::ftell(file));
+
+    // resume once the record is complete
+    std::fseek(file, 0, SEEK_END);
+    ASSERT_EQ(1u, std::fwrite(buffer.data() + 29, 1, 1, file));
+    std::fseek(file, 13, SEEK_SET);
+    EXPECT_EQ(1u, read_ump_records(file, format, result, timestamps, 4));
+    EXPECT_EQ(packets[1], result[0]);
+
+    // invalid word count
+    const uint8_t invalid = 3;
+    ASSERT_EQ(1u, std::fwrite(&invalid, 1, 1, file));
+    std::fseek(file, 30, SEEK_SET);
+    EXPECT_EQ(0u, read_ump_records(file, format, result, timestamps, 4));
+    EXPECT_EQ(30, std::ftell(file));
+    EXPECT_EQ(3, std::getc(file));
+
+    std::fclose(file);
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_serialization, file_round_trip)
+{
+    using namespace midi;
+
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(nullptr, file);
+
+    const ump_record_format format{ byte_order::big_endian, true };
+
+    std::vector<universal_packet> packets;
+    std::vector<uint64_t>         timestamps;
+    for (uint32_t i = 0; i < 2000; ++i)
+        for (const auto& p : make_packets())
+        {
+            packets.push_back(p);
+            timestamps.push_back(i);
+        }
+
+    EXPECT_TRUE(write_ump_record_header(file, format));
+    EXPECT_EQ(packets.size(), write_ump_records(file, format, packets.data(), timestamps.data(), packets.size()));
+    std::rewind(file);
+
+    const auto r = read_ump_record_header(file);
+    ASSERT_TRUE(r);
+    EXPECT_EQ(format, *r);
+
+    std::vector<universal_packet> result(packets.size() + 1);
+    std::vector<uint64_t>         result_timestamps(packets.size() + 1);
+    ASSERT_EQ(packets.size(),
+              read_ump_records(file, *r, result.data(), result_timestamps.data(), result.size()));
+    for (auto i = 0u; i < packets.size(); ++i)
+    {
+        EXPECT_EQ(packets[i], result[i]);
+        EXPECT_EQ(timestamps[i], result_timestamps[i]);
+    }
+
+    std::fclose(file);
+}
+
+//-----------------------------------------------
@@ -0,0 +1,256 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/ump_stream.h>
+
+#include <midi/midi1_channel_voice_message.h>
+#include <midi/midi2_channel_voice_message.h>
+#include <midi/system_message.h>
+
+#include <random>
+#include <vector>
+
+//-----------------------------------------------
+
+class ump_stream : public ::testing::Test
+{
+  public:
+};
+
+//-----------------------------------------------
+
+TEST_F(ump_stream, packet_size)
+{
+    using namespace midi;
+
+    for (uint32_t t = 0; t < 16; ++t)
+    {
+        EXPECT_EQ(universal_packet{ t << 28 }.size(), packet_size(packet_type(t)));
+    }
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_stream, packet_view)
+{
+    using namespace midi;
+
+    const uint32_t words[] = { 0x40912233, 0x12345678, 0xFFFFFFFF };
+
+    ump_packet_view v{ words };
+    EXPECT_EQ(packet_type::midi2_channel_voice, v.type());
+    EXPECT_EQ(2u, v.size());
+    EXPECT_EQ(0u, v.group());
+    EXPECT_EQ(0x91u, v.status());
+    EXPECT_TRUE(v.has_channel());
+    EXPECT_EQ(1u, v.channel());
+    EXPECT_EQ(0x22u, v.byte3());
+    EXPECT_EQ(0x33u, v.byte4());
+    EXPECT_EQ(0x12u, v.get_byte(4));
+    EXPECT_EQ(0x78u, v.get_byte(7));
+    EXPECT_EQ(0x12345678u, v[1]);
+    EXPECT_EQ(words, v.data());
+
+    const auto p = v.packet();
+    EXPECT_EQ((universal_packet{ 0x40912233, 0x12345678 }), p);
+    EXPECT_EQ(0u, p.data[2]);
+    EXPECT_EQ(0u, p.data[3]);
+    EXPECT_TRUE(v == p);
+    EXPECT_TRUE(v != universal_packet{ 0x40912233 });
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_stream, empty)
+{
+    using namespace midi;
+
+    ump_stream_view s;
+    EXPECT_TRUE(s.empty());
+    EXPECT_EQ(s.begin(), s.end());
+    EXPECT_EQ(0u, s.num_packets());
+    EXPECT_EQ(0u, s.num_incomplete_words());
+
+    const uint32_t words[] = { 0x40912233 };
+    ump_stream_view t{ words, 1 };
+    EXPECT_TRUE(t.empty());
+    EXPECT_EQ(0u, t.num_packets());
+    EXPECT_EQ(1u, t.num_incomplete_words());
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_stream, iterate)
+{
+    using namespace midi;
+
+    const std::vector<universal_packet> packets = {
+        make_midi1_note_on_message(3, 2, 60, velocity{ uint7_t{ 100 } }),
+        make_midi2_note_off_message(1, 5, 70, velocity{ uint16_t{ 0x1234 } }),
+        universal_packet{ 0x50001122, 0x33445566, 0x778899AA, 0xBBCCDDEE },
+        make_system_message(7, system_status::clock),
+        universal_packet{ 0x30160102, 0x03040506 },
+        universal_packet{ 0xF0000101, 0x02030405, 0x06070809, 0x0A0B0C0D },
+    };
+
+    std::vector<uint32_t> words;
+    for (const auto& p : packets)
+        for (auto w = 0u; w < p.size(); ++w)
+            words.push_back(p.data[w]);
+
+    ump_stream_view s{ words.data(), words.size() };
+    EXPECT_FALSE(s.empty());
+    EXPECT_EQ(packets.size(), s.num_packets());
+    EXPECT_EQ(0u, s.num_incomplete_words());
+    EXPECT_EQ(words.data(), s.data());
+    EXPECT_EQ(words.size(), s.size_in_words());
+
+    auto expected = packets.begin();
+    for (auto v : s)
+    {
+        ASSERT_NE(expected, packets.end());
+        EXPECT_EQ(expected->type(), v.type());
+        EXPECT_EQ(expected->size(), v.size());
+        EXPECT_EQ(*expected, v.packet());
+        ++expected;
+    }
+    EXPECT_EQ(expected, packets.end());
+
+    auto it  = s.begin();
+    auto old = it++;
+    EXPECT_EQ(words.data(), old.position());
+    EXPECT_EQ(words.data() + 1, it.position());
+    EXPECT_EQ(packet_type::midi2_channel_voice, (*it).type());
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_stream, truncated_trailing_packet)
+{
+    using namespace midi;
+
+    const uint32_t words[] = { 0x20903C64, 0x10F80000, 0x50001122, 0x33445566, 0x778899AA };
+
+    ump_stream_view s{ words, 5 };
+    EXPECT_EQ(2u, s.num_packets());
+    EXPECT_EQ(3u, s.num_incomplete_words());
+
+    std::vector<uint32_t> first_words;
+    for (auto v : s)
+        first_words.push_back(v[0]);
+    EXPECT_EQ((std::vector<uint32_t>{ 0x20903C64, 0x10F80000 }), first_words);
+
+    ump_stream_view t{ words, 2 };
+    EXPECT_EQ(2u, t.num_packets());
+    EXPECT_EQ(0u, t.num_incomplete_words());
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_stream, constexpr_evaluation)
+{
+    using namespace midi;
+
+    static constexpr uint32_t words[] = { 0x20903C64, 0x40912233, 0x12345678, 0x10F80000, 0x50001122 };
+
+    constexpr ump_stream_view s{ words, 5 };
+    static_assert(s.num_packets() == 3);
+    static_assert(s.num_incomplete_words() == 1);
+    static_assert((*s.begin()).status() == 0x90);
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_stream, classify_packets)
+{
+    using namespace midi;
+
+    std::mt19937                            rng{ 4711 };
+    std::uniform_int_distribution<uint32_t> dist;
+
+    for (size_t num_words : { 0u, 1u, 3u, 15u, 16u, 17u, 100u, 1027u })
+    {
+        std::vector<uint32_t> words(num_words);
+        for (auto& w : words)
+            w = dist(rng);
+
+        std::vector<uint32_t>    offsets(num_words + 1);
+        std::vector<packet_type> types(num_words);
+        std::vector<group_t>     groups(num_words);
+
+        const auto n =
+          classify_packets(words.data(), words.size(), offsets.data(), types.data(), groups.data(), num_words);
+
+        ump_stream_view s{ words.data(), words.size() };
+        EXPECT_EQ(s.num_packets(), n);
+        EXPECT_EQ(num_words - s.num_incomplete_words(), offsets[n]);
+
+        size_t i = 0;
+        for (auto it = s.begin(); it != s.end(); ++it, ++i)
+        {
+            ASSERT_LT(i, n);
+            EXPECT_EQ(it.position() - words.data(), offsets[i]);
+            EXPECT_EQ((*it).type(), types[i]);
+            EXPECT_EQ((*it).group(), groups[i]);
+            EXPECT_EQ((*it).size(), offsets[i + 1] - offsets[i]);
+        }
+    }
+}
+
+//-----------------------------------------------
+
+TEST_F(ump_stream, classify_packets_limits)
+{
+    using namespace midi;
+
+    std::vector<uint32_t> words;
+    for (uint32_t p = 0; p < 40; ++p)
+    {
+        words.push_back(0x20903C00u | (p % 16) << 24 | p);
+        words.push_back(0x40B01000u | (p % 16) << 24);
+        words.push_back(p);
+    }
+
+    std::vector<uint32_t> offsets(words.size() + 1);
+    std::vector<group_t>  groups(words.size());
+
+    // offsets only
+    auto n = classify_packets(words.data(), words.size(), offsets.data(), nullptr, nullptr, words.size());
+    EXPECT_EQ(80u, n);
+    EXPECT_EQ(words.size(), offsets[n]);
+    EXPECT_EQ(0u, offsets[0]);
+    EXPECT_EQ(1u, offsets[1]);
+    EXPECT_EQ(3u, offsets[2]);
+
+    // limited number of packets, groups only
+    n = classify_packets(words.data(), words.size(), offsets.data(), nullptr, groups.data(), 33);
+    EXPECT_EQ(33u, n);
+    EXPECT_EQ(49u, offsets[n]);
+    for (auto i = 0u; i < n; ++i)
+    {
+        EXPECT_EQ((i / 2) % 16, groups[i]);
+    }
+}
+
+//-----------------------------------------------
@@ -2,6 +2,7 @@
 
 #include <midi/universal_packet.h>
 
+#include <iomanip>
 #include <sstream>
 #include <string>
 
@@ -630,3 +631,118 @@ TEST_F(universal_midi_packet, stream_operators)
 }
 
 //-----------------------------------------------
+
+TEST_F(universal_midi_packet, to_chars)
+{
+    using namespace midi;
+
+    char buffer[max_packet_chars];
+
+    {
+        const universal_packet p(0x50123456, 0x789ABCDE, 0xFEDCBA98, 0x76543210);
+        const auto             r = to_chars(buffer, buffer + sizeof(buffer), p);
+        EXPECT_EQ(std::errc{}, r.ec);
+        EXPECT_EQ(std::string(buffer, r.ptr), "50123456 789abcde fedcba98 76543210");
+
+        std::stringstream s;
+        s << p;
+        EXPECT_EQ(s.str(), std::string(buffer, r.ptr));
+
+        // stream formatting flags are honoured
+        std::stringstream u;
+        u << std::uppercase << p;
+        EXPECT_EQ(u.str(), "50123456 789ABCDE FEDCBA98 76543210");
+        EXPECT_TRUE(u.flags() & std::ios_base::uppercase);
+
+        // a pending width is consumed by the packet
+        std::stringstream w;
+        w << std::setw(40) << p << 1;
+        EXPECT_EQ(w.str(), "50123456 789abcde fedcba98 765432101");
+        EXPECT_EQ(0, w.width());
+    }
+
+    {
+        const universal_packet p(0x20903C40);
+        const auto             r = to_chars(buffer, buffer + 8, p);
+        EXPECT_EQ(std::errc{}, r.ec);
+        EXPECT_EQ(std::string(buffer, r.ptr), "20903c40");
+
+        const auto e = to_chars(buffer, buffer + 7, p);
+        EXPECT_EQ(std::errc::value_too_large, e.ec);
+    }
+}
+
+//-----------------------------------------------
+
+TEST_F(universal_midi_packet, to_chars_bulk)
+{
+    using namespace midi;
+
+    const universal_packet packets[] = { universal_packet{ 0x10F80000 },
+                                         universal_packet{ 0x40903C00, 0x80000000 },
+                                         universal_packet{ 0x00000000 } };
+
+    char       buffer[64];
+    const auto r = to_chars(buffer, buffer + sizeof(buffer), packets, 3);
+    EXPECT_EQ(std::errc{}, r.ec);
+    EXPECT_EQ(std::string(buffer, r.ptr), "10f80000\n40903c00 80000000\n00000000\n");
+
+    const auto s = to_chars(buffer, buffer + sizeof(buffer), packets, 2, ';');
+    EXPECT_EQ(std::string(buffer, s.ptr), "10f80000;40903c00 80000000;");
+
+    EXPECT_EQ(std::errc::value_too_large, to_chars(buffer, buffer + 26, packets, 2).ec);
+}
+
+//-----------------------------------------------
+
+TEST_F(universal_midi_packet, from_chars)
+{
+    using namespace midi;
+
+    {
+        const std::string s{ "50123456 789ABCDE\tfedcba98  76543210 20903c40" };
+        universal_packet  p;
+        const auto        r = from_chars(s.data(), s.data() + s.size(), p);
+        EXPECT_EQ(std::errc{}, r.ec);
+        EXPECT_EQ(s.data() + 36, r.ptr);
+        EXPECT_EQ(universal_packet(0x50123456, 0x789ABCDE, 0xFEDCBA98, 0x76543210), p);
+    }
+
+    {
+        const std::string s{ "10F8 ignored" };
+        universal_packet  p;
+        const auto        r = from_chars(s.data(), s.data() + s.size(), p);
+        EXPECT_EQ(std::errc{}, r.ec);
+        EXPECT_EQ(s.data() + 4, r.ptr);
+        EXPECT_EQ(universal_packet{ 0x10F8 }, p);
+    }
+
+    {
+        const std::string      s{ "invaliddata" };
+        const universal_packet original{ 0x20903C40 };
+        universal_packet       p = original;
+        const auto             r = from_chars(s.data(), s.data() + s.size(), p);
+        EXPECT_EQ(std::errc::invalid_argument, r.ec);
+        EXPECT_EQ(s.data(), r.ptr);
+        EXPECT_EQ(original, p);
+    }
+
+    {
+        // missing second word
+        const std::string s{ "40903c00 " };
+        universal_packet  p;
+        const auto        r = from_chars(s.data(), s.data() + s.size(), p);
+        EXPECT_EQ(std::errc::invalid_argument, r.ec);
+        EXPECT_EQ(s.data(), r.ptr);
+    }
+
+    {
+        const std::string s{ "123456789" };
+        universal_packet  p;
+        const auto        r = from_chars(s.data(), s.data() + s.size(), p);
+        EXPECT_EQ(std::errc::result_out_of_range, r.ec);
+        EXPECT_EQ(s.data() + s.size(), r.ptr);
+    }
+}
+
+//-----------------------------------------------
@@ -0,0 +1,217 @@
+//
+// Copyright (c) 2023 Native Instruments
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <midi/usb_midi1.h>
+
+#include <midi/midi1_byte_stream.h>
+#include <midi/midi1_channel_voice_message.h>
+#include <midi/system_message.h>
+
+#include <iterator>
+#include <utility>
+#include <vector>
+
+//-----------------------------------------------
+
+class usb_midi1 : public ::testing::Test
+{
+  public:
+};
+
+//-----------------------------------------------
+
+TEST_F(usb_midi1, event)
+{
+    using namespace midi;
+
+    constexpr auto e = make_usb_midi1_event(3, 0x9, 0x91, 0x3C, 0x40);
+    static_assert(e.cable() == 3);
+    static_assert(e.code_index() == 0x9);
+    EXPECT_EQ(0x39, e.header);
+    EXPECT_EQ(0x91, e.midi[0]);
+    EXPECT_EQ(0x3C, e.midi[1]);
+    EXPECT_EQ(0x40, e.midi[2]);
+
+    EXPECT_EQ(e, make_usb_midi1_event(3, 0x9, 0x91, 0x3C, 0x40));
+    EXPECT_NE(e, make_usb_midi1_event(2, 0x9, 0x91, 0x3C, 0x40));
+
+    EXPECT_EQ(0u, usb_midi1_event_size(0x0));
+    EXPECT_EQ(2u, usb_midi1_event_size(0x2));
+    EXPECT_EQ(3u, usb_midi1_event_size(0x4));
+    EXPECT_EQ(1u, usb_midi1_event_size(0x5));
+    EXPECT_EQ(2u, usb_midi1_event_size(0xC));
+    EXPECT_EQ(1u, usb_midi1_event_size(0xF));
+}
+
+//-----------------------------------------------
+
+TEST_F(usb_midi1, decode_channel_voice_and_system_messages)
+{
+    using namespace midi;
+
+    const usb_midi1_event events[] = {
+        make_usb_midi1_event(0, 0x9, 0x90, 0x3C, 0x40), make_usb_midi1_event(1, 0xC, 0xC3, 0x05),
+        make_usb_midi1_event(2, 0xE, 0xE0, 0x00, 0x40), make_usb_midi1_event(3, 0xF, 0xF8),
+        make_usb_midi1_event(4, 0x2, 0xF3, 0x11),       make_usb_midi1_event(5, 0x3, 0xF2, 0x10, 0x20),
+        make_usb_midi1_event(6, 0x5, 0xF6),             make_usb_midi1_event(7, 0x0, 0x90, 0x3C, 0x40),
+        make_usb_midi1_event(8, 0xF, 0xFD),
+    };
+
+    const universal_packet expected[] = {
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::note_on, 0, 0x3C, 0x40),
+        make_midi1_channel_voice_message(1, midi1_channel_voice_status::program_change, 3, 0x05, 0),
+        make_midi1_channel_voice_message(2, midi1_channel_voice_status::pitch_bend, 0, 0x00, 0x40),
+        make_system_message(3, system_status::clock),
+        make_system_message(4, system_status::song_select, 0x11),
+        make_system_message(5, system_status::song_position, 0x10, 0x20),
+        make_system_message(6, system_status::tune_request),
+    };
+
+    usb_midi1_decoder decoder;
+
+    universal_packet packets[std::size(events) * usb_midi1_decoder::max_packets_per_event];
+    ASSERT_EQ(std::size(expected), decoder.decode(events, std::size(events), packets));
+    for (size_t p = 0; p < std::size(expected); ++p)
+        EXPECT_EQ(expected[p], packets[p]);
+}
+
+//-----------------------------------------------
+
+TEST_F(usb_midi1, decode_sysex)
+{
+    using namespace midi;
+
+    // interleaved SysEx messages on cables 1 and 2, realtime inside SysEx
+    const usb_midi1_event events[] = {
+        make_usb_midi1_event(1, 0x4, 0xF0, 0x7D, 0x01), make_usb_midi1_event(2, 0x6, 0xF0, 0xF7),
+        make_usb_midi1_event(1, 0x4, 0x02, 0x03, 0x04), make_usb_midi1_event(2, 0x7, 0xF0, 0x7E, 0xF7),
+        make_usb_midi1_event(1, 0xF, 0xF8),             make_usb_midi1_event(1, 0x4, 0x05, 0x06, 0x07),
+        make_usb_midi1_event(1, 0x6, 0x08, 0xF7),
+    };
+
+    std::vector<universal_packet> packets;
+
+    usb_midi1_decoder decoder;
+    decoder.decode(events, std::size(events), [&](const universal_packet& p) { packets.push_back(p); });
+
+    const universal_packet expected[] = {
+        { 0x32017E00, 0x00000000 },
+        make_system_message(1, system_status::clock),
+        { 0x31167D01, 0x02030405 },
+        { 0x31330607, 0x08000000 },
+    };
+    EXPECT_EQ(std::vector<universal_packet>(std::begin(expected), std::end(expected)), packets);
+}
+
+//-----------------------------------------------
+
+TEST_F(usb_midi1, encode)
+{
+    using namespace midi;
+
+    const universal_packet packets[] = {
+        make_midi1_channel_voice_message(0, midi1_channel_voice_status::note_on, 0, 0x3C, 0x40),
+        make_midi1_channel_voice_message(9, midi1_channel_voice_status::channel_pressure, 3, 0x05, 0),
+        make_system_message(3, system_status::clock),
+        make_system_message(4, system_status::mtc_quarter_frame, 0x11),
+        make_system_message(5, system_status::song_position, 0x10, 0x20),
+        make_system_message(6, system_status::tune_request),
+        { 0x30037D01, 0x02000000 },
+        { 0x31167D01, 0x02030405 },
+        { 0x31220607, 0x00000000 },
+        { 0x31330607, 0x08000000 },
+        { 0x40903C00, 0xFFFF0000 }, // MIDI 2 note on, ignored
+    };
+
+    const usb_midi1_event expected[] = {
+        make_usb_midi1_event(0, 0x9, 0x90, 0x3C, 0x40),
+        make_usb_midi1_event(9, 0xD, 0xD3, 0x05),
+        make_usb_midi1_event(3, 0xF, 0xF8),
+        make_usb_midi1_event(4, 0x2, 0xF1, 0x11),
+        make_usb_midi1_event(5, 0x3, 0xF2, 0x10, 0x20),
+        make_usb_midi1_event(6, 0x5, 0xF6),
+        make_usb_midi1_event(0, 0x4, 0xF0, 0x7D, 0x01),
+        make_usb_midi1_event(0, 0x6, 0x02, 0xF7),
+        make_usb_midi1_event(1, 0x4, 0xF0, 0x7D, 0x01),
+        make_usb_midi1_event(1, 0x4, 0x02, 0x03, 0x04),
+        make_usb_midi1_event(1, 0x4, 0x05, 0x06, 0x07),
+        make_usb_midi1_event(1, 0x4, 0x06, 0x07, 0x08),
+        make_usb_midi1_event(1, 0x5, 0xF7),
+    };
+
+    usb_midi1_encoder encoder;
+
+    usb_midi1_event events[std::size(packets) * usb_midi1_encoder::max_events_per_packet];
+    ASSERT_EQ(std::size(expected), encoder.encode(packets, std::size(packets), events));
+    for (size_t e = 0; e < std::size(expected); ++e)
+        EXPECT_EQ(expected[e], events[e]) << "event " << e;
+}
+
+//-----------------------------------------------
+
+TEST_F(usb_midi1, round_trip_matches_byte_stream_parser)
+{
+    std::vector<std::uint8_t> byte_stream = { 0x90, 0x3C, 0x40, 0x3E, 0x40, 0xF8, 0xF0, 0x00, 0x21, 0x09 };
+    for (auto i = 0u; i < 200; ++i)
+    {
+        byte_stream.push_back(std::uint8_t(i & 0x7F));
+        if (i % 41 == 0)
+            byte_stream.push_back(0xFE);
+    }
+    const std::vector<std::uint8_t> tail = { 0xF7, 0xB0, 0x07, 0x10, 0xF0, 0x7D, 0x01, 0xF7, 0xF2, 0x01, 0x02 };
+    byte_stream.insert(byte_stream.end(), tail.begin(), tail.end());
+
+    for (midi::group_t group = 0; group < 16; group += 5)
+    {
+        std::vector<midi::universal_packet> expected;
+        midi::midi1_byte_stream_parser      parser(group,
+                                              [&](midi::universal_packet p) { expected.push_back(p); });
+        parser.feed(byte_stream.data(), byte_stream.size());
+        ASSERT_FALSE(expected.empty());
+
+        std::vector<midi::usb_midi1_event> events;
+        midi::usb_midi1_encoder            encoder;
+        for (const auto& p : expected)
+            encoder.encode(p, [&](const midi::usb_midi1_event& e) {
+                EXPECT_EQ(group, e.cable());
+                events.push_back(e);
+            });
+
+        std::vector<midi::universal_packet> packets(events.size() * midi::usb_midi1_decoder::max_packets_per_event);
+        midi::usb_midi1_decoder             decoder;
+        packets.resize(decoder.decode(events.data(), events.size(), packets.data()));
+
+        // held back SysEx bytes may move realtime messages ahead of SysEx packets
+        const auto split_realtime = [](const std::vector<midi::universal_packet>& v) {
+            std::vector<midi::universal_packet> realtime, other;
+            for (const auto& p : v)
+                ((p.type() == midi::packet_type::system) && (p.status() >= 0xF8) ? realtime : other).push_back(p);
+            return std::make_pair(realtime, other);
+        };
+
+        EXPECT_EQ(split_realtime(expected), split_realtime(packets));
+    }
+}
+
+//-----------------------------------------------
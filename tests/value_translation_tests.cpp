@@ -120,3 +120,33 @@ TEST_F(value_translation, upsample_x_to_ybit)
         EXPECT_EQ(midi::upsample_14_to_32bit(v), midi::upsample_x_to_ybit(v, 14, 32));
     }
 }
+
+//-----------------------------------------------
+
+TEST_F(value_translation, bulk)
+{
+    using namespace midi;
+
+    uint7_t  v7[0x80];
+    uint32_t v32[0x80];
+    for (uint7_t v = 0u; v < 0x80; ++v)
+        v7[v] = v;
+
+    upsample_7_to_32bit(v7, 0x80, v32);
+    for (uint7_t v = 0u; v < 0x80; ++v)
+        EXPECT_EQ(upsample_7_to_32bit(v), v32[v]) << "7 -> 32 for " << int(v);
+
+    uint7_t back[0x80];
+    downsample_32_to_7bit(v32, 0x80, back);
+    for (uint7_t v = 0u; v < 0x80; ++v)
+        EXPECT_EQ(v, back[v]);
+
+    uint14_t v14[0x4000];
+    uint32_t v14_32[0x4000];
+    for (uint14_t v = 0u; v < 0x4000; ++v)
+        v14[v] = v;
+
+    upsample_14_to_32bit(v14, 0x4000, v14_32);
+    for (uint14_t v = 0u; v < 0x4000; ++v)
+        EXPECT_EQ(upsample_14_to_32bit(v), v14_32[v]) << "14 -> 32 for " << v;
+}